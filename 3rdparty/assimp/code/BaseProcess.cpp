@@ -46,6 +46,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../include/assimp/DefaultLogger.hpp"
 #include "../include/assimp/scene.h"
 #include "Importer.h"
+#include "WorkerPool.h"
+#include <algorithm>
 
 using namespace Assimp;
 
@@ -54,6 +56,7 @@ using namespace Assimp;
 BaseProcess::BaseProcess()
 : shared()
 , progress()
+, workers()
 {
 }
 
@@ -91,6 +94,59 @@ void BaseProcess::ExecuteOnScene( Importer* pImp)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ParallelForMeshes(const aiScene* pScene,
+    const std::function<void (unsigned int)>& job) const
+{
+    if (GetNumThreads() == 1 || pScene->mNumMeshes < 2) {
+        for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    // start with the largest meshes so no thread is left with a big one at the end
+    std::vector<std::pair<unsigned int, unsigned int> > order(pScene->mNumMeshes);
+    uint64_t total = 0;
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        const aiMesh* mesh = pScene->mMeshes[i];
+        order[i] = std::make_pair(~(mesh->mNumVertices + mesh->mNumFaces), i);
+        total += mesh->mNumVertices + mesh->mNumFaces;
+    }
+    std::sort(order.begin(), order.end());
+
+    // if one mesh holds most of the work, it gets all threads to itself
+    if (~order[0].first > total / 2) {
+        for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    workers->ParallelFor(pScene->mNumMeshes, [&](unsigned int i) {
+        job(order[i].second);
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ParallelFor(unsigned int count,
+    const std::function<void (unsigned int)>& job) const
+{
+    if (GetNumThreads() == 1) {
+        for (unsigned int i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+    workers->ParallelFor(count, job);
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int BaseProcess::GetNumThreads() const
+{
+    return workers && !WorkerPool::IsRunningJob() ? workers->GetNumThreads() : 1;
+}
+
 // ------------------------------------------------------------------------------------------------
 void BaseProcess::SetupProperties(const Importer* /*pImp*/)
 {
@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_BASEPROCESS_H
 
 #include <map>
+#include <functional>
 
 #include "../include/assimp/types.h"
 #include "GenericProperty.h"
@@ -52,6 +53,7 @@ struct aiScene;
 namespace Assimp    {
 
 class Importer;
+class WorkerPool;
 
 // ---------------------------------------------------------------------------
 /** Helper class to allow post-processing steps to interact with each other.
@@ -279,6 +281,46 @@ public:
         return shared;
     }
 
+    // -------------------------------------------------------------------
+    /** Assign the threads the step may spread its work across, see
+     *  #ParallelForMeshes(). The pool must outlive the next call to
+     *  ExecuteOnScene().
+     * @param pool May be NULL to run everything on the calling thread
+    */
+    inline void SetWorkerPool(WorkerPool* pool)    {
+        workers = pool;
+    }
+
+protected:
+
+    // -------------------------------------------------------------------
+    /** Call job(i) for each mesh i of the scene, spread across the
+     *  assigned worker pool if there is one. Steps use it for their loops
+     *  over meshes if each iteration only touches its own mesh. Anything
+     *  gathered per mesh has to go to a slot of that mesh and be combined
+     *  in mesh order afterwards, so the result doesn't depend on the number
+     *  of threads. Larger meshes are handed out first. A scene dominated
+     *  by one mesh is processed mesh by mesh instead, leaving the threads
+     *  to #ParallelFor() loops within that mesh.
+     */
+    void ParallelForMeshes(const aiScene* pScene,
+        const std::function<void (unsigned int)>& job) const;
+
+    // -------------------------------------------------------------------
+    /** Call job(i) for each i in [0,count), spread across the assigned
+     *  worker pool. Runs serially if there is no pool or if called from
+     *  a job of #ParallelForMeshes(), whose threads are busy already.
+     */
+    void ParallelFor(unsigned int count,
+        const std::function<void (unsigned int)>& job) const;
+
+    // -------------------------------------------------------------------
+    /** Get the number of threads #ParallelFor() would use right now.
+     *  Steps use it to skip setting up parallel work that would run
+     *  serially anyway.
+     */
+    unsigned int GetNumThreads() const;
+
 protected:
 
     /** See the doc of #SharedPostProcessInfo for more details */
@@ -286,6 +328,9 @@ protected:
 
     /** Currently active progress handler */
     ProgressHandler* progress;
+
+    /** Threads for #ParallelForMeshes() and #ParallelFor(), may be NULL */
+    WorkerPool* workers;
 };
 
 
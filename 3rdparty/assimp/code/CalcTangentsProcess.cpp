@@ -95,9 +95,14 @@ void CalcTangentsProcess::Execute( aiScene* pScene)
 
     DefaultLogger::get()->debug("CalcTangentsProcess begin");
 
+    std::vector<unsigned char> abHas(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        abHas[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     bool bHas = false;
     for ( unsigned int a = 0; a < pScene->mNumMeshes; a++ ) {
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
+        if(abHas[a])bHas = true;
     }
 
     if ( bHas ) {
@@ -142,7 +147,7 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
 
     const float angleEpsilon = 0.9999f;
 
-    std::vector<bool> vertexDone( pMesh->mNumVertices, false);
+    std::vector<unsigned char> vertexDone( pMesh->mNumVertices, false);
     const float qnan = get_qnan();
 
     // create space for the tangents and bitangents
@@ -254,17 +259,14 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
-    std::vector<unsigned int> verticesFound;
-
     const float fLimit = cosf(configMaxAngle);
-    std::vector<unsigned int> closeVertices;
 
     // in the second pass we now smooth out all tangents and bitangents at the same local position
     // if they are not too far off.
-    for( unsigned int a = 0; a < pMesh->mNumVertices; a++)
-    {
+    auto smoothVertex = [&](unsigned int a, std::vector<unsigned int>& verticesFound,
+        std::vector<unsigned int>& closeVertices) {
         if( vertexDone[a])
-            continue;
+            return;
 
         const aiVector3D& origPos = pMesh->mVertices[a];
         const aiVector3D& origNorm = pMesh->mNormals[a];
@@ -312,6 +314,31 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             meshTang[ closeVertices[b] ] = smoothTangent;
             meshBitang[ closeVertices[b] ] = smoothBitangent;
         }
+    };
+
+    // Smoothing only touches vertices close to the current one and depends on the order, so
+    // with several threads groups of vertices apart from each other are run in parallel, each
+    // of them in the original order.
+    const unsigned int numThreads = GetNumThreads();
+    if (numThreads == 1) {
+        std::vector<unsigned int> verticesFound;
+        std::vector<unsigned int> closeVertices;
+        for( unsigned int a = 0; a < pMesh->mNumVertices; a++) {
+            smoothVertex(a, verticesFound, closeVertices);
+        }
+    }
+    else {
+        std::vector<unsigned int> groupOffsets, groupVertices;
+        const unsigned int numGroups = GroupCloseVertices(pMesh, *vertexFinder, posEpsilon,
+            numThreads * 16, groupOffsets, groupVertices);
+
+        ParallelFor(numGroups, [&](unsigned int g) {
+            std::vector<unsigned int> verticesFound;
+            std::vector<unsigned int> closeVertices;
+            for( unsigned int n = groupOffsets[g]; n < groupOffsets[g+1]; n++) {
+                smoothVertex(groupVertices[n], verticesFound, closeVertices);
+            }
+        });
     }
     return true;
 }
@@ -62,6 +62,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 boost::mutex loggerMutex;
 #endif
 
+#include <mutex>
+
+// post processing steps may log from several threads at once
+static std::mutex streamMutex;
+
 namespace Assimp    {
 
 // ----------------------------------------------------------------------------------
@@ -375,6 +380,7 @@ void DefaultLogger::WriteToStreams(const char *message,
     ErrorSeverity ErrorSev )
 {
     ai_assert(NULL != message);
+    std::lock_guard<std::mutex> lock(streamMutex);
 
     // Check whether this is a repeated message
     if (! ::strncmp( message,lastMsg, lastLen-1))
@@ -237,7 +237,7 @@ bool Exporter :: IsDefaultIOHandler() const
 
 
 // ------------------------------------------------------------------------------------------------
-const aiExportDataBlob* Exporter :: ExportToBlob(  const aiScene* pScene, const char* pFormatId, unsigned int, const ExportProperties* pProperties)
+const aiExportDataBlob* Exporter :: ExportToBlob(  const aiScene* pScene, const char* pFormatId, unsigned int pPreprocessing, const ExportProperties* pProperties)
 {
     if (pimpl->blob) {
         delete pimpl->blob;
@@ -250,7 +250,7 @@ const aiExportDataBlob* Exporter :: ExportToBlob(  const aiScene* pScene, const
     BlobIOSystem* blobio = new BlobIOSystem();
     pimpl->mIOSystem = boost::shared_ptr<IOSystem>( blobio );
 
-    if (AI_SUCCESS != Export(pScene,pFormatId,blobio->GetMagicFileName())) {
+    if (AI_SUCCESS != Export(pScene,pFormatId,blobio->GetMagicFileName(), pPreprocessing, pProperties)) {
         pimpl->mIOSystem = old;
         return NULL;
     }
@@ -310,12 +310,6 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
 
             try {
 
-                // Always create a full copy of the scene. We might optimize this one day,
-                // but for now it is the most pragmatic way.
-                aiScene* scenecopy_tmp;
-                SceneCombiner::CopyScene(&scenecopy_tmp,pScene);
-
-                std::auto_ptr<aiScene> scenecopy(scenecopy_tmp);
                 const ScenePrivateData* const priv = ScenePriv(pScene);
 
                 // steps that are not idempotent, i.e. we might need to run them again, usually to get back to the
@@ -338,9 +332,9 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
                 // If the input scene is not in verbose format, but there is at least postprocessing step that relies on it,
                 // we need to run the MakeVerboseFormat step first.
                 bool must_join_again = false;
+                bool verbosify = false;
                 if (!is_verbose_format) {
 
-                    bool verbosify = false;
                     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++) {
                         BaseProcess* const p = pimpl->mPostProcessingSteps[a];
 
@@ -349,16 +343,27 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
                             break;
                         }
                     }
+                    verbosify = verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices);
+                }
+
+                // Exporters get a const scene and must not change it, so a copy of the scene is only
+                // needed if we're going to modify it ourselves. Otherwise, the input scene is passed
+                // through as-is, which saves a full copy of all vertex data.
+                std::auto_ptr<aiScene> scenecopy;
+                if (pp || verbosify) {
+                    aiScene* scenecopy_tmp;
+                    SceneCombiner::CopyScene(&scenecopy_tmp,pScene);
+                    scenecopy.reset(scenecopy_tmp);
+                }
 
-                    if (verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                        DefaultLogger::get()->debug("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
+                if (verbosify) {
+                    DefaultLogger::get()->debug("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
 
-                        MakeVerboseFormatProcess proc;
-                        proc.Execute(scenecopy.get());
+                    MakeVerboseFormatProcess proc;
+                    proc.Execute(scenecopy.get());
 
-                        if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                            must_join_again = true;
-                        }
+                    if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
+                        must_join_again = true;
                     }
                 }
 
@@ -409,7 +414,7 @@ aiReturn Exporter :: Export( const aiScene* pScene, const char* pFormatId, const
                 }
 
                 ExportProperties emptyProperties;  // Never pass NULL ExportProperties so Exporters don't have to worry.
-                exp.mExportFunction(pPath,pimpl->mIOSystem.get(),scenecopy.get(), pProperties ? pProperties : &emptyProperties);
+                exp.mExportFunction(pPath,pimpl->mIOSystem.get(),scenecopy.get() ? scenecopy.get() : pScene, pProperties ? pProperties : &emptyProperties);
             }
             catch (DeadlyExportError& err) {
                 pimpl->mError = err.what();
@@ -85,9 +85,9 @@ void FindDegeneratesProcess::SetupProperties(const Importer* pImp)
 void FindDegeneratesProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("FindDegeneratesProcess begin");
-    for (unsigned int i = 0; i < pScene->mNumMeshes;++i){
+    ParallelForMeshes(pScene, [&](unsigned int i) {
         ExecuteOnMesh( pScene->mMeshes[i]);
-    }
+    });
     DefaultLogger::get()->debug("FindDegeneratesProcess finished");
 }
 
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseProcess.h"
 #include "ProcessHelper.h"
+#include "Hash.h"
 
 class FindInstancesProcessTest;
 namespace Assimp    {
@@ -72,6 +73,47 @@ inline uint64_t GetMeshHash(aiMesh* in)
         (in->mPrimitiveTypes<<28)) & 0xffffffff );
 }
 
+// -------------------------------------------------------------------------------
+/** @brief Get a hash of the data of a mesh.
+ *
+ *  Extends GetMeshHash() by the vertex and face streams of the mesh.
+ *  The data is hashed bit by bit, so meshes which are equal only within
+ *  the tolerances FindInstancesProcess allows get different hashes.
+ *  @param in Input mesh
+ *  @return Hash.
+ */
+inline uint64_t GetMeshContentHash(aiMesh* in)
+{
+    uint64_t hash = GetMeshHash(in);
+    const size_t size = in->mNumVertices * sizeof(aiVector3D);
+
+    if (in->HasPositions()) {
+        hash = XXHash64(in->mVertices, size, hash);
+    }
+    if (in->HasNormals()) {
+        hash = XXHash64(in->mNormals, size, hash);
+    }
+    if (in->HasTangentsAndBitangents()) {
+        hash = XXHash64(in->mTangents, size, hash);
+        hash = XXHash64(in->mBitangents, size, hash);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (in->mTextureCoords[i]) {
+            hash = XXHash64(in->mTextureCoords[i], size, hash);
+        }
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        if (in->mColors[i]) {
+            hash = XXHash64(in->mColors[i], in->mNumVertices * sizeof(aiColor4D), hash);
+        }
+    }
+    for (unsigned int i = 0; i < in->mNumFaces; ++i) {
+        const aiFace& f = in->mFaces[i];
+        hash = XXHash64(f.mIndices, f.mNumIndices * sizeof(unsigned int), hash);
+    }
+    return hash;
+}
+
 // -------------------------------------------------------------------------------
 /** @brief Perform a component-wise comparison of two arrays
  *
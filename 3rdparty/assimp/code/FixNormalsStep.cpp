@@ -81,9 +81,14 @@ void FixInfacingNormalsProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("FixInfacingNormalsProcess begin");
 
+    std::vector<unsigned char> abHas(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        abHas[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
+        if(abHas[a])bHas = true;
 
     if (bHas)
          DefaultLogger::get()->debug("FixInfacingNormalsProcess finished. Found issues.");
@@ -85,9 +85,14 @@ void GenFaceNormalsProcess::Execute( aiScene* pScene)
         throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
     }
 
+    std::vector<unsigned char> abHas(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        abHas[a] = this->GenMeshFaceNormals( pScene->mMeshes[a]);
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)   {
-        if(this->GenMeshFaceNormals( pScene->mMeshes[a])) {
+        if(abHas[a]) {
             bHas = true;
         }
     }
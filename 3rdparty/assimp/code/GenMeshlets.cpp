@@ -0,0 +1,356 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  GenMeshlets.cpp
+ *  @brief Implementation of the aiProcess_GenMeshlets step
+ */
+
+
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+
+
+#include "GenMeshlets.h"
+#include "VertexTriangleAdjacency.h"
+#include "../include/assimp/postprocess.h"
+#include "../include/assimp/scene.h"
+#include "../include/assimp/DefaultLogger.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <stdio.h>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Count the distinct vertices of a face which aren't marked as part of the cluster yet
+inline unsigned int CountNewVertices(const aiFace& face, const std::vector<unsigned int>& marks, unsigned int cluster)
+{
+    const unsigned int a = face.mIndices[0], b = face.mIndices[1], c = face.mIndices[2];
+    return (marks[a] != cluster) + (marks[b] != cluster && b != a) + (marks[c] != cluster && c != a && c != b);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Bounding sphere of a set of points after Ritter: start from the two points furthest
+// apart along one axis, then grow the sphere to include each point outside of it.
+void ComputeSphere(const aiVector3D* positions, const std::vector<unsigned int>& vertices, aiVector3D& center,
+    float& radius)
+{
+    unsigned int min[3], max[3];
+    std::fill(min, min + 3, vertices[0]);
+    std::fill(max, max + 3, vertices[0]);
+    for (size_t i = 1; i < vertices.size(); ++i) {
+        const aiVector3D& p = positions[vertices[i]];
+        for (unsigned int k = 0; k < 3; ++k) {
+            if (p[k] < positions[min[k]][k]) {
+                min[k] = vertices[i];
+            }
+            if (p[k] > positions[max[k]][k]) {
+                max[k] = vertices[i];
+            }
+        }
+    }
+
+    unsigned int axis = 0;
+    for (unsigned int k = 1; k < 3; ++k) {
+        if ((positions[max[k]] - positions[min[k]]).SquareLength() >
+            (positions[max[axis]] - positions[min[axis]]).SquareLength()) {
+            axis = k;
+        }
+    }
+
+    center = (positions[min[axis]] + positions[max[axis]]) * 0.5f;
+    radius = (positions[max[axis]] - center).Length();
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const aiVector3D& p = positions[vertices[i]];
+        const float distance = (p - center).Length();
+        if (distance > radius) {
+            // move the center towards p just enough to cover it
+            const float grown = (radius + distance) * 0.5f;
+            center += (p - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Normal cone of a set of triangles, see Meshlet
+void ComputeCone(const aiMesh* mesh, unsigned int first, unsigned int count, aiVector3D& axis, float& cutoff)
+{
+    std::vector<aiVector3D> normals;
+    normals.reserve(count);
+
+    aiVector3D sum;
+    for (unsigned int i = first; i < first + count; ++i) {
+        const aiFace& face = mesh->mFaces[i];
+        const aiVector3D& a = mesh->mVertices[face.mIndices[0]];
+        aiVector3D n = (mesh->mVertices[face.mIndices[1]] - a) ^ (mesh->mVertices[face.mIndices[2]] - a);
+
+        // degenerate faces can't be seen from any side
+        const float length = n.Length();
+        if (length > 0.f) {
+            n /= length;
+            normals.push_back(n);
+            sum += n;
+        }
+    }
+
+    axis = aiVector3D();
+    cutoff = 1.f;
+
+    const float length = sum.Length();
+    if (length <= 0.f) {
+        return;
+    }
+
+    const aiVector3D average = sum / length;
+    float min_dot = 1.f;
+    for (size_t i = 0; i < normals.size(); ++i) {
+        min_dot = std::min(min_dot, normals[i] * average);
+    }
+
+    // a cone of 90 degrees or more contains front-facing triangles from anywhere
+    if (min_dot > 0.f) {
+        axis = average;
+        cutoff = std::sqrt(1.f - min_dot * min_dot);
+    }
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+GenMeshletsProcess::GenMeshletsProcess()
+    : mMaxVertices(AI_GM_DEFAULT_MAX_VERTICES)
+    , mMaxFaces(AI_GM_DEFAULT_MAX_TRIANGLES)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+GenMeshletsProcess::~GenMeshletsProcess()
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool GenMeshletsProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_GenMeshlets) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the postprocessing step
+void GenMeshletsProcess::SetupProperties(const Importer* pImp)
+{
+    mMaxVertices = pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES,AI_GM_DEFAULT_MAX_VERTICES);
+    mMaxFaces = pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES,AI_GM_DEFAULT_MAX_TRIANGLES);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void GenMeshletsProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("GenMeshletsProcess begin");
+
+    if (mMaxVertices < 3 || !mMaxFaces) {
+        DefaultLogger::get()->error("GenMeshletsProcess: a cluster needs room for at least one triangle");
+        return;
+    }
+
+    std::vector<unsigned char> reordered(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int i) {
+        reordered[i] = ProcessMesh(pScene->mMeshes[i]);
+    });
+
+    unsigned int processed = 0;
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        processed += reordered[i];
+    }
+
+    char szBuffer[128];
+    ::sprintf(szBuffer,"GenMeshletsProcess finished. Reordered the faces of %u meshes",processed);
+    DefaultLogger::get()->info(szBuffer);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool GenMeshletsProcess::ProcessMesh(aiMesh* mesh) const
+{
+    if (!mesh->mNumFaces || mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        return false;
+    }
+
+    const unsigned int numFaces = mesh->mNumFaces;
+    VertexTriangleAdjacency adj(mesh->mFaces, numFaces, mesh->mNumVertices, true);
+
+    std::vector<unsigned int> order;
+    order.reserve(numFaces);
+    std::vector<bool> emitted(numFaces, false);
+
+    // vertices and candidate faces are marked with the number of the cluster
+    // they are part of, or next to
+    std::vector<unsigned int> vertexMarks(mesh->mNumVertices, 0), faceMarks(numFaces, 0);
+    std::vector<unsigned int> candidates;
+    unsigned int cluster = 1, clusterVertices = 0, clusterFaces = 0, cursor = 0;
+
+    while (order.size() < numFaces) {
+
+        // the neighbour adding the fewest vertices, preferring faces whose
+        // vertices have few faces left so no small islands stay behind
+        unsigned int best = UINT_MAX, bestNew = UINT_MAX, bestLive = UINT_MAX;
+        size_t kept = 0;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            const unsigned int f = candidates[i];
+            if (emitted[f]) {
+                continue;
+            }
+            candidates[kept++] = f;
+
+            const aiFace& face = mesh->mFaces[f];
+            const unsigned int added = CountNewVertices(face, vertexMarks, cluster);
+            const unsigned int live = adj.GetNumTrianglesPtr(face.mIndices[0]) +
+                adj.GetNumTrianglesPtr(face.mIndices[1]) + adj.GetNumTrianglesPtr(face.mIndices[2]);
+            if (added < bestNew || (added == bestNew && live < bestLive)) {
+                best = f;
+                bestNew = added;
+                bestLive = live;
+            }
+        }
+        candidates.resize(kept);
+
+        // nothing left next to the cluster: continue with the first unused face
+        if (best == UINT_MAX) {
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = cursor;
+            bestNew = CountNewVertices(mesh->mFaces[best], vertexMarks, cluster);
+        }
+
+        // start a new cluster exactly where GetMeshlets() will
+        if (clusterFaces == mMaxFaces || clusterVertices + bestNew > mMaxVertices) {
+            ++cluster;
+            clusterVertices = clusterFaces = 0;
+            candidates.clear();
+        }
+
+        emitted[best] = true;
+        order.push_back(best);
+        ++clusterFaces;
+
+        const aiFace& face = mesh->mFaces[best];
+        for (unsigned int k = 0; k < 3; ++k) {
+            const unsigned int v = face.mIndices[k];
+            if (vertexMarks[v] != cluster) {
+                vertexMarks[v] = cluster;
+                ++clusterVertices;
+            }
+            --adj.GetNumTrianglesPtr(v);
+
+            const unsigned int* const faces = adj.GetAdjacentTriangles(v);
+            for (unsigned int j = 0, end = adj.mOffsetTable[v + 1] - adj.mOffsetTable[v]; j < end; ++j) {
+                if (!emitted[faces[j]] && faceMarks[faces[j]] != cluster) {
+                    faceMarks[faces[j]] = cluster;
+                    candidates.push_back(faces[j]);
+                }
+            }
+        }
+    }
+
+    // move the faces into their new order, the index arrays stay where they are
+    aiFace* const faces = new aiFace[numFaces];
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        aiFace& source = mesh->mFaces[order[i]];
+        faces[i].mNumIndices = source.mNumIndices;
+        faces[i].mIndices = source.mIndices;
+        source.mIndices = NULL;
+    }
+    delete[] mesh->mFaces;
+    mesh->mFaces = faces;
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GenMeshletsProcess::GetMeshlets(const aiMesh* mesh, unsigned int maxVertices, unsigned int maxFaces,
+    std::vector<Meshlet>& out)
+{
+    out.clear();
+    if (!mesh->mNumFaces || mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        return;
+    }
+
+    std::vector<unsigned int> marks(mesh->mNumVertices, 0), vertices;
+    vertices.reserve(maxVertices);
+
+    Meshlet m;
+    m.mFirstFace = 0;
+    for (unsigned int i = 0, cluster = 1; i <= mesh->mNumFaces; ++i) {
+        const unsigned int faces = i - m.mFirstFace;
+        if (i == mesh->mNumFaces || faces == maxFaces ||
+            vertices.size() + CountNewVertices(mesh->mFaces[i], marks, cluster) > maxVertices) {
+
+            m.mNumFaces = faces;
+            ComputeSphere(mesh->mVertices, vertices, m.mCenter, m.mRadius);
+            ComputeCone(mesh, m.mFirstFace, faces, m.mConeAxis, m.mConeCutoff);
+            out.push_back(m);
+
+            if (i == mesh->mNumFaces) {
+                break;
+            }
+            m.mFirstFace = i;
+            vertices.clear();
+            ++cluster;
+        }
+
+        const aiFace& face = mesh->mFaces[i];
+        for (unsigned int k = 0; k < 3; ++k) {
+            if (marks[face.mIndices[k]] != cluster) {
+                marks[face.mIndices[k]] = cluster;
+                vertices.push_back(face.mIndices[k]);
+            }
+        }
+    }
+}
+
+#endif // !! ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
@@ -0,0 +1,143 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  GenMeshlets.h
+ *  @brief Declares a post processing step to reorder the faces of meshes into clusters
+ */
+#ifndef AI_GENMESHLETSPROCESS_H_INC
+#define AI_GENMESHLETSPROCESS_H_INC
+
+#include "BaseProcess.h"
+#include "../include/assimp/vector3.h"
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp    {
+
+// ---------------------------------------------------------------------------
+/** @brief A run of consecutive triangles of a mesh with its culling data.
+ *
+ *  The cluster is entirely back-facing for a viewer at eye if
+ *  <tt>dot(mCenter - eye, mConeAxis) >= mConeCutoff * length(mCenter - eye) + mRadius</tt>.
+ *  Clusters whose normals spread too far for that have a zero axis and a
+ *  cutoff of 1, so the test never passes.
+ */
+struct Meshlet
+{
+    unsigned int mFirstFace;
+    unsigned int mNumFaces;
+
+    //! Bounding sphere of the cluster's vertices
+    aiVector3D mCenter;
+    float mRadius;
+
+    //! Average face normal and sine of the largest angle between it and
+    //! any face normal
+    aiVector3D mConeAxis;
+    float mConeCutoff;
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Postprocessing step to reorder the faces of each mesh into
+ *  clusters of adjacent triangles with a bounded number of vertices and
+ *  triangles.
+ *
+ *  Clusters are grown greedily from the first unused triangle, always
+ *  adding the triangle next to the cluster which brings in the fewest new
+ *  vertices. No cluster tables are stored as aiMesh has no place for them:
+ *  GetMeshlets() finds the clusters again in a single pass, which is cheap
+ *  compared to growing them.
+ */
+class GenMeshletsProcess : public BaseProcess
+{
+public:
+
+    GenMeshletsProcess();
+    ~GenMeshletsProcess();
+
+public:
+    // -------------------------------------------------------------------
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    void Execute( aiScene* pScene);
+
+    // -------------------------------------------------------------------
+    void SetupProperties(const Importer* pImp);
+
+public:
+
+    // -------------------------------------------------------------------
+    /** @brief Reorder the faces of a mesh into clusters.
+     *  @return false if the mesh isn't made of triangles only and has
+     *    been left alone. */
+    bool ProcessMesh(aiMesh* mesh) const;
+
+    // -------------------------------------------------------------------
+    /** @brief Get the clusters of a mesh and their culling data.
+     *
+     *  Faces are taken in order, each cluster ends where the next face
+     *  would exceed either limit. Pass the limits the mesh was processed
+     *  with to get the clusters built by ProcessMesh().
+     *  @param mesh Mesh made of triangles only, otherwise out is left
+     *    empty.
+     *  @param maxVertices Maximum number of vertices per cluster, at
+     *    least 3.
+     *  @param maxFaces Maximum number of triangles per cluster.
+     *  @param out Receives the clusters in face order.
+     */
+    static void GetMeshlets(const aiMesh* mesh, unsigned int maxVertices, unsigned int maxFaces,
+        std::vector<Meshlet>& out);
+
+    // -------------------------------------------------------------------
+    void SetLimits(unsigned int maxVertices, unsigned int maxFaces) {
+        mMaxVertices = maxVertices;
+        mMaxFaces = maxFaces;
+    }
+
+private:
+
+    unsigned int mMaxVertices, mMaxFaces;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_GENMESHLETSPROCESS_H_INC
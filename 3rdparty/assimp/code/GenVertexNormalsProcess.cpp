@@ -92,10 +92,15 @@ void GenVertexNormalsProcess::Execute( aiScene* pScene)
     if (pScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT)
         throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
 
+    std::vector<unsigned char> abHas(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        abHas[a] = GenMeshVertexNormals( pScene->mMeshes[a],a);
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
     {
-        if(GenMeshVertexNormals( pScene->mMeshes[a],a))
+        if(abHas[a])
             bHas = true;
     }
 
@@ -171,17 +176,16 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
-    std::vector<unsigned int> verticesFound;
     aiVector3D* pcNew = new aiVector3D[pMesh->mNumVertices];
 
     if (configMaxAngle >= AI_DEG_TO_RAD( 175.f ))   {
         // There is no angle limit. Thus all vertices with positions close
         // to each other will receive the same vertex normal. This allows us
         // to optimize the whole algorithm a little bit ...
-        std::vector<bool> abHad(pMesh->mNumVertices,false);
-        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
+        std::vector<unsigned char> abHad(pMesh->mNumVertices,false);
+        auto smoothVertex = [&](unsigned int i, std::vector<unsigned int>& verticesFound) {
             if (abHad[i]) {
-                continue;
+                return;
             }
 
             // Get all vertices that share this one ...
@@ -201,32 +205,61 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
                 pcNew[vidx] = pcNor;
                 abHad[vidx] = true;
             }
+        };
+
+        // Which vertex of a group is found first depends on the order, so
+        // with several threads the loop is split into groups apart from
+        // each other, each of them run in the original order.
+        const unsigned int numThreads = GetNumThreads();
+        if (numThreads == 1) {
+            std::vector<unsigned int> verticesFound;
+            for (unsigned int i = 0; i < pMesh->mNumVertices; ++i) {
+                smoothVertex(i, verticesFound);
+            }
+        }
+        else {
+            std::vector<unsigned int> groupOffsets, groupVertices;
+            const unsigned int numGroups = GroupCloseVertices(pMesh, *vertexFinder, posEpsilon,
+                numThreads * 16, groupOffsets, groupVertices);
+
+            ParallelFor(numGroups, [&](unsigned int g) {
+                std::vector<unsigned int> verticesFound;
+                for (unsigned int n = groupOffsets[g]; n < groupOffsets[g+1]; ++n) {
+                    smoothVertex(groupVertices[n], verticesFound);
+                }
+            });
         }
     }
     // Slower code path if a smooth angle is set. There are many ways to achieve
-    // the effect, this one is the most straightforward one.
+    // the effect, this one is the most straightforward one. Each vertex is
+    // independent of all others, so the vertices are split into ranges.
     else    {
         const float fLimit = std::cos(configMaxAngle);
-        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
-            // Get all vertices that share this one ...
-            vertexFinder->FindPositions( pMesh->mVertices[i] , posEpsilon, verticesFound);
-
-            aiVector3D vr = pMesh->mNormals[i];
-            float vrlen = vr.Length();
-
-            aiVector3D pcNor;
-            for (unsigned int a = 0; a < verticesFound.size(); ++a) {
-                aiVector3D v = pMesh->mNormals[verticesFound[a]];
-
-                // check whether the angle between the two normals is not too large
-                // HACK: if v.x is qnan the dot product will become qnan, too
-                //   therefore the comparison against fLimit should be false
-                //   in every case.
-                if (v * vr >= fLimit * vrlen * v.Length())
-                    pcNor += v;
+        const unsigned int rangeSize = 4096;
+        ParallelFor((pMesh->mNumVertices + rangeSize - 1) / rangeSize, [&](unsigned int r) {
+            std::vector<unsigned int> verticesFound;
+            const unsigned int end = std::min(pMesh->mNumVertices, (r + 1) * rangeSize);
+            for (unsigned int i = r * rangeSize; i < end;++i)   {
+                // Get all vertices that share this one ...
+                vertexFinder->FindPositions( pMesh->mVertices[i] , posEpsilon, verticesFound);
+
+                aiVector3D vr = pMesh->mNormals[i];
+                float vrlen = vr.Length();
+
+                aiVector3D pcNor;
+                for (unsigned int a = 0; a < verticesFound.size(); ++a) {
+                    aiVector3D v = pMesh->mNormals[verticesFound[a]];
+
+                    // check whether the angle between the two normals is not too large
+                    // HACK: if v.x is qnan the dot product will become qnan, too
+                    //   therefore the comparison against fLimit should be false
+                    //   in every case.
+                    if (v * vr >= fLimit * vrlen * v.Length())
+                        pcNor += v;
+                }
+                pcNew[i] = pcNor.Normalize();
             }
-            pcNew[i] = pcNor.Normalize();
-        }
+        });
     }
 
     delete[] pMesh->mNormals;
@@ -113,4 +113,107 @@ int rem;
     return hash;
 }
 
+// ------------------------------------------------------------------------------------------------
+// 64 bit hashing function, an implementation of xxHash64 by Yann Collet
+// https://github.com/Cyan4973/xxHash (BSD 2-clause license)
+//
+// Processes 32 bytes per round, far faster than SuperFastHash on large inputs and with
+// few enough collisions to use the hash as a content key. Pass the result of a previous
+// call as seed to hash several blocks in sequence.
+// ------------------------------------------------------------------------------------------------
+namespace Intern {
+
+    const uint64_t kXXPrime1 = 11400714785074694791ULL;
+    const uint64_t kXXPrime2 = 14029467366897019727ULL;
+    const uint64_t kXXPrime3 =  1609587929392839161ULL;
+    const uint64_t kXXPrime4 =  9650029242287828579ULL;
+    const uint64_t kXXPrime5 =  2870177450012600261ULL;
+
+    inline uint64_t XXRotl64(uint64_t v, int r) {
+        return (v << r) | (v >> (64 - r));
+    }
+
+    inline uint64_t XXRead64(const uint8_t* p) {
+        uint64_t v;
+        ::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint32_t XXRead32(const uint8_t* p) {
+        uint32_t v;
+        ::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t XXRound(uint64_t acc, uint64_t input) {
+        acc += input * kXXPrime2;
+        acc  = XXRotl64(acc, 31);
+        return acc * kXXPrime1;
+    }
+
+    inline uint64_t XXMergeRound(uint64_t acc, uint64_t val) {
+        acc ^= XXRound(0, val);
+        return acc * kXXPrime1 + kXXPrime4;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+inline uint64_t XXHash64 (const void* data, size_t len, uint64_t seed = 0) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + len;
+    uint64_t hash;
+
+    if (len >= 32) {
+        const uint8_t* const limit = end - 32;
+        uint64_t v1 = seed + Intern::kXXPrime1 + Intern::kXXPrime2;
+        uint64_t v2 = seed + Intern::kXXPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Intern::kXXPrime1;
+
+        do {
+            v1 = Intern::XXRound(v1, Intern::XXRead64(p));
+            v2 = Intern::XXRound(v2, Intern::XXRead64(p + 8));
+            v3 = Intern::XXRound(v3, Intern::XXRead64(p + 16));
+            v4 = Intern::XXRound(v4, Intern::XXRead64(p + 24));
+            p += 32;
+        }
+        while (p <= limit);
+
+        hash = Intern::XXRotl64(v1, 1) + Intern::XXRotl64(v2, 7) + Intern::XXRotl64(v3, 12) + Intern::XXRotl64(v4, 18);
+        hash = Intern::XXMergeRound(hash, v1);
+        hash = Intern::XXMergeRound(hash, v2);
+        hash = Intern::XXMergeRound(hash, v3);
+        hash = Intern::XXMergeRound(hash, v4);
+    }
+    else {
+        hash = seed + Intern::kXXPrime5;
+    }
+
+    hash += static_cast<uint64_t>(len);
+
+    /* Handle end cases */
+    for (; p + 8 <= end; p += 8) {
+        hash ^= Intern::XXRound(0, Intern::XXRead64(p));
+        hash  = Intern::XXRotl64(hash, 27) * Intern::kXXPrime1 + Intern::kXXPrime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(Intern::XXRead32(p)) * Intern::kXXPrime1;
+        hash  = Intern::XXRotl64(hash, 23) * Intern::kXXPrime2 + Intern::kXXPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= (*p) * Intern::kXXPrime5;
+        hash  = Intern::XXRotl64(hash, 11) * Intern::kXXPrime1;
+    }
+
+    /* Force avalanching */
+    hash ^= hash >> 33;
+    hash *= Intern::kXXPrime2;
+    hash ^= hash >> 29;
+    hash *= Intern::kXXPrime3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
 #endif // !! AI_HASH_H_INCLUDED
@@ -73,9 +73,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ScenePrivate.h"
 #include "MemoryIOWrapper.h"
 #include "Profiler.h"
+#include "WorkerPool.h"
 #include "TinyFormatter.h"
 #include "Exceptional.h"
-#include "Profiler.h"
 #include <set>
 #include <boost/scoped_ptr.hpp>
 #include <cctype>
@@ -83,6 +83,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
 #   include "ValidateDataStructure.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_SPLITLARGEMESHES_PROCESS
+#   include "SplitLargeMeshes.h"
+#endif
 
 using namespace Assimp::Profiling;
 using namespace Assimp::Formatter;
@@ -97,6 +100,72 @@ namespace Assimp {
 using namespace Assimp;
 using namespace Assimp::Intern;
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Get a name for a post processing step to report measurements under. Steps don't have names,
+// so look for the flag which activates them. A few steps share a flag or serve several.
+std::string GetPostProcessingStepName(const BaseProcess* process)
+{
+    if (dynamic_cast<const ComputeSpatialSortProcess*>(process)) {
+        return "postprocess:ComputeSpatialSort";
+    }
+    if (dynamic_cast<const DestroySpatialSortProcess*>(process)) {
+        return "postprocess:DestroySpatialSort";
+    }
+#ifndef ASSIMP_BUILD_NO_SPLITLARGEMESHES_PROCESS
+    if (dynamic_cast<const SplitLargeMeshesProcess_Triangle*>(process)) {
+        return "postprocess:SplitLargeMeshes_Triangle";
+    }
+    if (dynamic_cast<const SplitLargeMeshesProcess_Vertex*>(process)) {
+        return "postprocess:SplitLargeMeshes_Vertex";
+    }
+#endif
+
+    static const struct {
+        unsigned int flag;
+        const char* name;
+    } names[] = {
+        { aiProcess_CalcTangentSpace,         "CalcTangentSpace" },
+        { aiProcess_JoinIdenticalVertices,    "JoinIdenticalVertices" },
+        { aiProcess_MakeLeftHanded,           "MakeLeftHanded" },
+        { aiProcess_Triangulate,              "Triangulate" },
+        { aiProcess_RemoveComponent,          "RemoveComponent" },
+        { aiProcess_GenNormals,               "GenNormals" },
+        { aiProcess_GenSmoothNormals,         "GenSmoothNormals" },
+        { aiProcess_SplitLargeMeshes,         "SplitLargeMeshes" },
+        { aiProcess_PreTransformVertices,     "PreTransformVertices" },
+        { aiProcess_LimitBoneWeights,         "LimitBoneWeights" },
+        { aiProcess_ValidateDataStructure,    "ValidateDataStructure" },
+        { aiProcess_ImproveCacheLocality,     "ImproveCacheLocality" },
+        { aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials" },
+        { aiProcess_FixInfacingNormals,       "FixInfacingNormals" },
+        { aiProcess_SortByPType,              "SortByPType" },
+        { aiProcess_FindDegenerates,          "FindDegenerates" },
+        { aiProcess_FindInvalidData,          "FindInvalidData" },
+        { aiProcess_GenUVCoords,              "GenUVCoords" },
+        { aiProcess_TransformUVCoords,        "TransformUVCoords" },
+        { aiProcess_FindInstances,            "FindInstances" },
+        { aiProcess_OptimizeMeshes,           "OptimizeMeshes" },
+        { aiProcess_OptimizeGraph,            "OptimizeGraph" },
+        { aiProcess_FlipUVs,                  "FlipUVs" },
+        { aiProcess_FlipWindingOrder,         "FlipWindingOrder" },
+        { aiProcess_SplitByBoneCount,         "SplitByBoneCount" },
+        { aiProcess_Debone,                   "Debone" },
+        { aiProcess_SimplifyMeshes,           "SimplifyMeshes" },
+        { aiProcess_GenMeshlets,              "GenMeshlets" },
+    };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        if (process->IsActive(names[i].flag)) {
+            return std::string("postprocess:") + names[i].name;
+        }
+    }
+    return "postprocess:unknown";
+}
+
+} // !anon
+
 // ------------------------------------------------------------------------------------------------
 // Intern::AllocateFromAssimpHeap serves as abstract base class. It overrides
 // new and delete (and their array counterparts) of public API classes (e.g. Logger) to
@@ -610,7 +679,8 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
             return NULL;
         }
 
-        boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
+        pimpl->mProfile.clear();
+        boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler(&pimpl->mProfile):NULL);
         if (profiler) {
             profiler->BeginRegion("total");
         }
@@ -659,15 +729,17 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
         DefaultLogger::get()->info("Found a matching importer for this file format");
         pimpl->mProgressHandler->UpdateFileRead( 0, fileSize );
 
+        const aiImporterDesc* const desc = imp->GetInfo();
+        const std::string import_region = std::string("import:") + (desc ? desc->mName : "unknown");
         if (profiler) {
-            profiler->BeginRegion("import");
+            profiler->BeginRegion(import_region);
         }
 
         pimpl->mScene = imp->ReadFile( this, pFile, pimpl->mIOHandler);
         pimpl->mProgressHandler->UpdateFileRead( fileSize, fileSize );
 
         if (profiler) {
-            profiler->EndRegion("import");
+            profiler->EndRegion(import_region, pimpl->mScene);
         }
 
         // If successful, apply all active post processing steps to the imported data
@@ -687,14 +759,14 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
 
             // Preprocess the scene and prepare it for post-processing
             if (profiler) {
-                profiler->BeginRegion("preprocess");
+                profiler->BeginRegion("preprocess", pimpl->mScene);
             }
 
             ScenePreprocessor pre(pimpl->mScene);
             pre.ProcessScene();
 
             if (profiler) {
-                profiler->EndRegion("preprocess");
+                profiler->EndRegion("preprocess", pimpl->mScene);
             }
 
             // Ensure that the validation process won't be called twice
@@ -709,7 +781,7 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
         pimpl->mPPShared->Clean();
 
         if (profiler) {
-            profiler->EndRegion("total");
+            profiler->EndRegion("total", pimpl->mScene);
         }
     }
 #ifdef ASSIMP_CATCH_GLOBAL_EXCEPTIONS
@@ -778,21 +850,30 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
     }
 #endif // ! DEBUG
 
-    boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
+    boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler(&pimpl->mProfile):NULL);
+
+    // threads for the steps to spread their meshes across, see BaseProcess::ParallelForMeshes().
+    // Called from a job of another pool, the loops would run inline anyway, so don't start any.
+    const int numThreads = WorkerPool::IsRunningJob() ? 1 : GetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS,1);
+    boost::scoped_ptr<WorkerPool> workers(numThreads != 1 ? new WorkerPool(numThreads > 0 ? numThreads : 0) : NULL);
+
     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)   {
 
         BaseProcess* process = pimpl->mPostProcessingSteps[a];
         pimpl->mProgressHandler->UpdatePostProcess( a, pimpl->mPostProcessingSteps.size() );
         if( process->IsActive( pFlags)) {
 
+            const std::string region = profiler ? GetPostProcessingStepName(process) : std::string();
             if (profiler) {
-                profiler->BeginRegion("postprocess");
+                profiler->BeginRegion(region, pimpl->mScene);
             }
 
+            process->SetWorkerPool( workers.get() );
             process->ExecuteOnScene ( this );
+            process->SetWorkerPool( NULL );
 
             if (profiler) {
-                profiler->EndRegion("postprocess");
+                profiler->EndRegion(region, pimpl->mScene);
             }
         }
         if( !pimpl->mScene) {
@@ -1012,6 +1093,13 @@ inline void AddNodeWeight(unsigned int& iScene,const aiNode* pcNode)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Get the measurements of the last import
+const ProfileRegionList& Importer::GetProfile() const
+{
+    return pimpl->mProfile;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get the memory requirements of the scene
 void Importer::GetMemoryRequirements(aiMemoryInfo& in) const
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <vector>
 #include "../include/assimp/matrix4x4.h"
+#include "../include/assimp/Profiling.hpp"
 
 struct aiScene;
 
@@ -119,6 +120,9 @@ public:
 
     /** Used by post-process steps to share data */
     SharedPostProcessInfo* mPPShared;
+
+    /** Measurements of the last import, see AI_CONFIG_GLOB_MEASURE_TIME */
+    ProfileRegionList mProfile;
 };
 //! @endcond
 
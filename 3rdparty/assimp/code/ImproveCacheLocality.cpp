@@ -98,10 +98,15 @@ void ImproveCacheLocalityProcess::Execute( aiScene* pScene)
 
     DefaultLogger::get()->debug("ImproveCacheLocalityProcess begin");
 
+    std::vector<float> results(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        results[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     float out = 0.f;
     unsigned int numf = 0, numm = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++){
-        const float res = ProcessMesh( pScene->mMeshes[a],a);
+        const float res = results[a];
         if (res) {
             numf += pScene->mMeshes[a]->mNumFaces;
             out  += res;
@@ -51,12 +51,157 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Vertex.h"
 #include "TinyFormatter.h"
 #include <stdio.h>
+#include <string.h>
 #include <boost/static_assert.hpp>
 
 using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// A per-vertex attribute array, compared and hashed as raw bytes
+struct VertexStream
+{
+    const unsigned char* data;
+    unsigned int size;
+};
+
+// ------------------------------------------------------------------------------------------------
+uint64_t HashVertex(const VertexStream* streams, unsigned int numStreams, unsigned int index)
+{
+    uint64_t hash = 0;
+    for (unsigned int s = 0; s < numStreams; ++s) {
+        const unsigned char* const p = streams[s].data + static_cast<size_t>(index) * streams[s].size;
+        for (unsigned int k = 0; k < streams[s].size; k += 4) {
+            uint32_t word;
+            ::memcpy(&word, p + k, 4);
+            hash = (hash + word) * 0x9E3779B97F4A7C15ull;
+        }
+    }
+    return hash ^ (hash >> 32);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool IsSameVertex(const VertexStream* streams, unsigned int numStreams, unsigned int a, unsigned int b)
+{
+    for (unsigned int s = 0; s < numStreams; ++s) {
+        const unsigned int size = streams[s].size;
+        if (::memcmp(streams[s].data + static_cast<size_t>(a) * size, streams[s].data + static_cast<size_t>(b) * size, size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Replace a vertex attribute array by the entries of the unique vertices
+template <typename T>
+void GatherUnique(T*& data, const std::vector<unsigned int>& uniqueSource)
+{
+    if (!data) {
+        return;
+    }
+    T* const out = new T[uniqueSource.size()];
+    for (size_t a = 0; a < uniqueSource.size(); a++) {
+        out[a] = data[uniqueSource[a]];
+    }
+    delete [] data;
+    data = out;
+}
+
+// ------------------------------------------------------------------------------------------------
+void LogMeshResult(const aiMesh* pMesh, unsigned int meshIndex, unsigned int numOldVertices)
+{
+    if (!DefaultLogger::isNullLogger() && DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE)    {
+        DefaultLogger::get()->debug((Formatter::format(),
+            "Mesh ",meshIndex,
+            " (",
+            (pMesh->mName.length ? pMesh->mName.data : "unnamed"),
+            ") | Verts in: ",numOldVertices,
+            " out: ",
+            pMesh->mNumVertices,
+            " | ~",
+            ((numOldVertices - pMesh->mNumVertices) / (float)numOldVertices) * 100.f,
+            "%"
+        ));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Point faces and bone weights at the unique vertices
+void UpdateReferences(aiMesh* pMesh, const std::vector<unsigned int>& replaceIndex)
+{
+    // adjust the indices in all faces
+    for( unsigned int a = 0; a < pMesh->mNumFaces; a++)
+    {
+        aiFace& face = pMesh->mFaces[a];
+        for( unsigned int b = 0; b < face.mNumIndices; b++) {
+            face.mIndices[b] = replaceIndex[face.mIndices[b]] & ~0x80000000;
+        }
+    }
+
+    // adjust bone vertex weights.
+    for( int a = 0; a < (int)pMesh->mNumBones; a++)
+    {
+        aiBone* bone = pMesh->mBones[a];
+        std::vector<aiVertexWeight> newWeights;
+        newWeights.reserve( bone->mNumWeights);
+
+        for( unsigned int b = 0; b < bone->mNumWeights; b++)
+        {
+            const aiVertexWeight& ow = bone->mWeights[b];
+            // if the vertex is a unique one, translate it
+            if( !(replaceIndex[ow.mVertexId] & 0x80000000))
+            {
+                aiVertexWeight nw;
+                nw.mVertexId = replaceIndex[ow.mVertexId];
+                nw.mWeight = ow.mWeight;
+                newWeights.push_back( nw);
+            }
+        }
+
+        if (newWeights.size() > 0) {
+            // kill the old and replace them with the translated weights
+            delete [] bone->mWeights;
+            bone->mNumWeights = (unsigned int)newWeights.size();
+
+            bone->mWeights = new aiVertexWeight[bone->mNumWeights];
+            memcpy( bone->mWeights, &newWeights[0], bone->mNumWeights * sizeof( aiVertexWeight));
+        }
+        else {
+
+            /*  NOTE:
+             *
+             *  In the algorithm above we're assuming that there are no vertices
+             *  with a different bone weight setup at the same position. That wouldn't
+             *  make sense, but it is not absolutely impossible. SkeletonMeshBuilder
+             *  for example generates such input data if two skeleton points
+             *  share the same position. Again this doesn't make sense but is
+             *  reality for some model formats (MD5 for example uses these special
+             *  nodes as attachment tags for its weapons).
+             *
+             *  Then it is possible that a bone has no weights anymore .... as a quick
+             *  workaround, we're just removing these bones. If they're animated,
+             *  model geometry might be modified but at least there's no risk of a crash.
+             */
+            delete bone;
+            --pMesh->mNumBones;
+            for (unsigned int n = a; n < pMesh->mNumBones; ++n)  {
+                pMesh->mBones[n] = pMesh->mBones[n+1];
+            }
+
+            --a;
+            DefaultLogger::get()->warn("Removing bone -> no weights remaining");
+        }
+    }
+}
+
+} // !anon
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 JoinVerticesProcess::JoinVerticesProcess()
+: configExact (false)
 {
     // nothing to do here
 }
@@ -74,6 +219,14 @@ bool JoinVerticesProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Setup import configuration
+void JoinVerticesProcess::SetupProperties(const Importer* pImp)
+{
+    // Get the current value of AI_CONFIG_PP_JV_EXACT
+    configExact = (0 != pImp->GetPropertyInteger(AI_CONFIG_PP_JV_EXACT,0));
+}
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void JoinVerticesProcess::Execute( aiScene* pScene)
@@ -89,9 +242,14 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
     }
 
     // execute the step
+    std::vector<int> aiNumVertices(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        aiNumVertices[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     int iNumVertices = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+        iNumVertices += aiNumVertices[a];
 
     // if logging is active, print detailed statistics
     if (!DefaultLogger::isNullLogger())
@@ -137,6 +295,31 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
     BOOST_STATIC_ASSERT(AI_MAX_VERTICES == 0x7fffffff);
     std::vector<unsigned int> replaceIndex( pMesh->mNumVertices, 0xffffffff);
 
+    // Exact matches only: one pass over a hash table, no need for the spatial sort
+    // nor for copies of the vertices.
+    if (configExact) {
+        const unsigned int numOldVertices = pMesh->mNumVertices;
+
+        std::vector<unsigned int> uniqueSource;
+        FindExactDuplicates( pMesh, replaceIndex, uniqueSource);
+        pMesh->mNumVertices = (unsigned int)uniqueSource.size();
+        LogMeshResult( pMesh, meshIndex, numOldVertices);
+
+        GatherUnique( pMesh->mVertices, uniqueSource);
+        GatherUnique( pMesh->mNormals, uniqueSource);
+        GatherUnique( pMesh->mTangents, uniqueSource);
+        GatherUnique( pMesh->mBitangents, uniqueSource);
+        for( unsigned int a = 0; a < AI_MAX_NUMBER_OF_COLOR_SETS; a++) {
+            GatherUnique( pMesh->mColors[a], uniqueSource);
+        }
+        for( unsigned int a = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; a++) {
+            GatherUnique( pMesh->mTextureCoords[a], uniqueSource);
+        }
+
+        UpdateReferences( pMesh, replaceIndex);
+        return pMesh->mNumVertices;
+    }
+
     // A little helper to find locally close vertices faster.
     // Try to reuse the lookup table from the last step.
     const static float epsilon = 1e-5f;
@@ -272,22 +455,11 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         }
     }
 
-    if (!DefaultLogger::isNullLogger() && DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE)    {
-        DefaultLogger::get()->debug((Formatter::format(),
-            "Mesh ",meshIndex,
-            " (",
-            (pMesh->mName.length ? pMesh->mName.data : "unnamed"),
-            ") | Verts in: ",pMesh->mNumVertices,
-            " out: ",
-            uniqueVertices.size(),
-            " | ~",
-            ((pMesh->mNumVertices - uniqueVertices.size()) / (float)pMesh->mNumVertices) * 100.f,
-            "%"
-        ));
-    }
+    const unsigned int numOldVertices = pMesh->mNumVertices;
 
     // replace vertex data with the unique data sets
     pMesh->mNumVertices = (unsigned int)uniqueVertices.size();
+    LogMeshResult( pMesh, meshIndex, numOldVertices);
 
     // ----------------------------------------------------------------------------
     // NOTE - we're *not* calling Vertex::SortBack() because it would check for
@@ -347,70 +519,63 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         }
     }
 
-    // adjust the indices in all faces
-    for( unsigned int a = 0; a < pMesh->mNumFaces; a++)
-    {
-        aiFace& face = pMesh->mFaces[a];
-        for( unsigned int b = 0; b < face.mNumIndices; b++) {
-            face.mIndices[b] = replaceIndex[face.mIndices[b]] & ~0x80000000;
+    UpdateReferences( pMesh, replaceIndex);
+    return pMesh->mNumVertices;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finds the bit-identical vertices of a mesh
+void JoinVerticesProcess::FindExactDuplicates( const aiMesh* pMesh, std::vector<unsigned int>& replaceIndex,
+    std::vector<unsigned int>& uniqueSource) const
+{
+    // only the attributes the mesh has take part
+    VertexStream streams[4 + AI_MAX_NUMBER_OF_COLOR_SETS + AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    unsigned int numStreams = 0;
+
+    const aiVector3D* const vectors[] = { pMesh->mVertices, pMesh->mNormals, pMesh->mTangents, pMesh->mBitangents };
+    for( unsigned int a = 0; a < 4; a++) {
+        if (vectors[a]) {
+            streams[numStreams].data = reinterpret_cast<const unsigned char*>(vectors[a]);
+            streams[numStreams++].size = sizeof(aiVector3D);
         }
     }
+    for( unsigned int a = 0; pMesh->HasVertexColors(a); a++) {
+        streams[numStreams].data = reinterpret_cast<const unsigned char*>(pMesh->mColors[a]);
+        streams[numStreams++].size = sizeof(aiColor4D);
+    }
+    for( unsigned int a = 0; pMesh->HasTextureCoords(a); a++) {
+        streams[numStreams].data = reinterpret_cast<const unsigned char*>(pMesh->mTextureCoords[a]);
+        streams[numStreams++].size = sizeof(aiVector3D);
+    }
 
-    // adjust bone vertex weights.
-    for( int a = 0; a < (int)pMesh->mNumBones; a++)
-    {
-        aiBone* bone = pMesh->mBones[a];
-        std::vector<aiVertexWeight> newWeights;
-        newWeights.reserve( bone->mNumWeights);
+    // open addressing with linear probing, at most half full. Slots hold the
+    // index of the source vertex of a unique vertex.
+    unsigned int bits = 4;
+    while ((size_t(1) << bits) < size_t(pMesh->mNumVertices) * 2) {
+        ++bits;
+    }
+    const size_t mask = (size_t(1) << bits) - 1;
+    std::vector<unsigned int> table( mask + 1, 0xffffffff);
 
-        for( unsigned int b = 0; b < bone->mNumWeights; b++)
-        {
-            const aiVertexWeight& ow = bone->mWeights[b];
-            // if the vertex is a unique one, translate it
-            if( !(replaceIndex[ow.mVertexId] & 0x80000000))
-            {
-                aiVertexWeight nw;
-                nw.mVertexId = replaceIndex[ow.mVertexId];
-                nw.mWeight = ow.mWeight;
-                newWeights.push_back( nw);
-            }
-        }
+    uniqueSource.clear();
+    uniqueSource.reserve( pMesh->mNumVertices);
 
-        if (newWeights.size() > 0) {
-            // kill the old and replace them with the translated weights
-            delete [] bone->mWeights;
-            bone->mNumWeights = (unsigned int)newWeights.size();
+    for( unsigned int a = 0; a < pMesh->mNumVertices; a++) {
+        // the high bits of a multiplicative hash are the well mixed ones
+        size_t slot = static_cast<size_t>(HashVertex( streams, numStreams, a) >> (64 - bits));
+        while (table[slot] != 0xffffffff && !IsSameVertex( streams, numStreams, table[slot], a)) {
+            slot = (slot + 1) & mask;
+        }
 
-            bone->mWeights = new aiVertexWeight[bone->mNumWeights];
-            memcpy( bone->mWeights, &newWeights[0], bone->mNumWeights * sizeof( aiVertexWeight));
+        if (table[slot] == 0xffffffff) {
+            table[slot] = a;
+            replaceIndex[a] = (unsigned int)uniqueSource.size();
+            uniqueSource.push_back( a);
         }
         else {
-
-            /*  NOTE:
-             *
-             *  In the algorithm above we're assuming that there are no vertices
-             *  with a different bone weight setup at the same position. That wouldn't
-             *  make sense, but it is not absolutely impossible. SkeletonMeshBuilder
-             *  for example generates such input data if two skeleton points
-             *  share the same position. Again this doesn't make sense but is
-             *  reality for some model formats (MD5 for example uses these special
-             *  nodes as attachment tags for its weapons).
-             *
-             *  Then it is possible that a bone has no weights anymore .... as a quick
-             *  workaround, we're just removing these bones. If they're animated,
-             *  model geometry might be modified but at least there's no risk of a crash.
-             */
-            delete bone;
-            --pMesh->mNumBones;
-            for (unsigned int n = a; n < pMesh->mNumBones; ++n)  {
-                pMesh->mBones[n] = pMesh->mBones[n+1];
-            }
-
-            --a;
-            DefaultLogger::get()->warn("Removing bone -> no weights remaining");
+            replaceIndex[a] = replaceIndex[table[slot]] | 0x80000000;
         }
     }
-    return pMesh->mNumVertices;
 }
 
 #endif // !! ASSIMP_BUILD_NO_JOINVERTICES_PROCESS
@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseProcess.h"
 #include "../include/assimp/types.h"
+#include <vector>
 struct aiMesh;
 
 namespace Assimp
@@ -81,6 +82,13 @@ public:
     */
     void Execute( aiScene* pScene);
 
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
 public:
     // -------------------------------------------------------------------
     /** Unites identical vertices in the given mesh.
@@ -89,7 +97,28 @@ public:
      */
     int ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
+    // -------------------------------------------------------------------
+    /** @brief Join only bit-identical vertices, see #AI_CONFIG_PP_JV_EXACT
+     */
+    void EnableExactMatching(bool d) {
+        configExact = d;
+    }
+
 private:
+
+    // -------------------------------------------------------------------
+    /** Find the bit-identical vertices of a mesh through a hash table.
+     * @param replaceIndex Receives the index of the unique vertex for each
+     *   vertex, with the highest bit set if it is a duplicate.
+     * @param uniqueSource Receives the index of the source vertex of each
+     *   unique vertex. */
+    void FindExactDuplicates( const aiMesh* pMesh, std::vector<unsigned int>& replaceIndex,
+        std::vector<unsigned int>& uniqueSource) const;
+
+private:
+
+    //! Configuration option: join bit-identical vertices only
+    bool configExact;
 };
 
 } // end of namespace Assimp
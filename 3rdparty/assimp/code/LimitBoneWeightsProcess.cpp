@@ -76,8 +76,9 @@ bool LimitBoneWeightsProcess::IsActive( unsigned int pFlags) const
 void LimitBoneWeightsProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("LimitBoneWeightsProcess begin");
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
+    ParallelForMeshes(pScene, [&](unsigned int a) {
         ProcessMesh( pScene->mMeshes[a]);
+    });
 
     DefaultLogger::get()->debug("LimitBoneWeightsProcess end");
 }
@@ -120,6 +120,12 @@ corresponding preprocessor flag to selectively disable steps.
 #ifndef ASSIMP_BUILD_NO_DEBONE_PROCESS
 #   include "DeboneProcess.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_SIMPLIFYMESHES_PROCESS
+#   include "SimplifyMeshes.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+#   include "GenMeshlets.h"
+#endif
 
 namespace Assimp {
 
@@ -212,6 +218,9 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
     out.push_back( new DestroySpatialSortProcess());
     // .........................................................................
 
+#if (!defined ASSIMP_BUILD_NO_SIMPLIFYMESHES_PROCESS)
+    out.push_back( new SimplifyMeshesProcess());
+#endif
 #if (!defined ASSIMP_BUILD_NO_SPLITLARGEMESHES_PROCESS)
     out.push_back( new SplitLargeMeshesProcess_Vertex());
 #endif
@@ -224,6 +233,9 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
 #if (!defined ASSIMP_BUILD_NO_IMPROVECACHELOCALITY_PROCESS)
     out.push_back( new ImproveCacheLocalityProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_GENMESHLETS_PROCESS)
+    out.push_back( new GenMeshletsProcess());
+#endif
 }
 
 }
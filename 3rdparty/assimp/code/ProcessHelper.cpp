@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include <limits>
+#include <algorithm>
 
 namespace Assimp {
 
@@ -167,6 +168,88 @@ float ComputePositionEpsilon(const aiMesh* const* pMeshes, size_t num)
     return (maxVec - minVec).Length() * epsilon;
 }
 
+// -------------------------------------------------------------------------------
+unsigned int GroupCloseVertices(const aiMesh* pMesh, const SpatialSort& finder, float radius,
+    unsigned int maxGroups, std::vector<unsigned int>& offsets, std::vector<unsigned int>& vertices)
+{
+    const unsigned int numVertices = pMesh->mNumVertices;
+
+    // cut the mesh into slabs along its longest axis, each some radii thick
+    aiVector3D minVec, maxVec;
+    ArrayBounds(pMesh->mVertices,numVertices,minVec,maxVec);
+    const aiVector3D size = maxVec - minVec;
+    const unsigned int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+
+    unsigned int numSlabs = 1;
+    const float thickness = 16.f * radius;
+    if (maxGroups > 1 && thickness > 0.f && size[axis] > thickness && size[axis] <= std::numeric_limits<float>::max()) {
+        numSlabs = static_cast<unsigned int>(std::min(static_cast<float>(maxGroups), size[axis] / thickness));
+    }
+
+    std::vector<unsigned int> slab(numVertices, 0), parent(numSlabs);
+    for (unsigned int s = 0; s < numSlabs; ++s) {
+        parent[s] = s;
+    }
+
+    if (numSlabs > 1) {
+        const float scale = numSlabs / size[axis];
+        for (unsigned int v = 0; v < numVertices; ++v) {
+            const float x = (pMesh->mVertices[v][axis] - minVec[axis]) * scale;
+            slab[v] = x > 0.f ? std::min(static_cast<unsigned int>(x), numSlabs - 1) : 0;
+        }
+
+        // only vertices close to the border of their slab can find vertices of
+        // the next one, the slabs of such pairs are merged into one group
+        const float margin = 2.f * radius * scale;
+        std::vector<unsigned int> found;
+        for (unsigned int v = 0; v < numVertices; ++v) {
+            const float x = (pMesh->mVertices[v][axis] - minVec[axis]) * scale - slab[v];
+            if (x >= margin && x <= 1.f - margin) {
+                continue;
+            }
+
+            finder.FindPositions(pMesh->mVertices[v], radius, found);
+            for (unsigned int i = 0; i < found.size(); ++i) {
+                unsigned int a = slab[v], b = slab[found[i]];
+                while (parent[a] != a) {
+                    a = parent[a] = parent[parent[a]];
+                }
+                while (parent[b] != b) {
+                    b = parent[b] = parent[parent[b]];
+                }
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+
+    // number the groups, the root of each is its first slab
+    std::vector<unsigned int> group(numSlabs);
+    unsigned int numGroups = 0;
+    for (unsigned int s = 0; s < numSlabs; ++s) {
+        unsigned int root = s;
+        while (parent[root] != root) {
+            root = parent[root];
+        }
+        group[s] = root == s ? numGroups++ : group[root];
+    }
+
+    // and list the vertices of each group
+    offsets.assign(numGroups + 1, 0);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        ++offsets[group[slab[v]] + 1];
+    }
+    for (unsigned int g = 0; g < numGroups; ++g) {
+        offsets[g + 1] += offsets[g];
+    }
+
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    vertices.resize(numVertices);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        vertices[fill[group[slab[v]]]++] = v;
+    }
+    return numGroups;
+}
+
 
 // -------------------------------------------------------------------------------
 unsigned int GetMeshVFormatUnique(const aiMesh* pcMesh)
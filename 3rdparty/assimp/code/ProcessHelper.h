@@ -301,6 +301,16 @@ float ComputePositionEpsilon(const aiMesh* pMesh);
 float ComputePositionEpsilon(const aiMesh* const* pMeshes, size_t num);
 
 
+// -------------------------------------------------------------------------------
+// Split the vertices of a mesh into at most maxGroups groups, so that every vertex
+// SpatialSort::FindPositions() finds for a vertex is in the same group as that vertex.
+// Loops whose iterations only touch vertices close to the current one can then run
+// the groups in parallel. Group g holds vertices[offsets[g]] to vertices[offsets[g+1]-1],
+// in ascending order. Returns the number of groups.
+unsigned int GroupCloseVertices(const aiMesh* pMesh, const SpatialSort& finder, float radius,
+    unsigned int maxGroups, std::vector<unsigned int>& offsets, std::vector<unsigned int>& vertices);
+
+
 // -------------------------------------------------------------------------------
 // Compute an unique value for the vertex format of a mesh
 unsigned int GetMeshVFormatUnique(const aiMesh* pcMesh);
@@ -349,14 +359,13 @@ class ComputeSpatialSortProcess : public BaseProcess
         DefaultLogger::get()->debug("Generate spatially-sorted vertex cache");
 
         std::vector<_Type>* p = new std::vector<_Type>(pScene->mNumMeshes);
-        std::vector<_Type>::iterator it = p->begin();
 
-        for (unsigned int i = 0; i < pScene->mNumMeshes; ++i, ++it) {
+        ParallelForMeshes(pScene, [&](unsigned int i) {
             aiMesh* mesh = pScene->mMeshes[i];
-            _Type& blubb = *it;
+            _Type& blubb = (*p)[i];
             blubb.first.Fill(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D));
             blubb.second = ComputePositionEpsilon(mesh);
-        }
+        });
 
         shared->AddProperty(AI_SPP_SPATIAL_SORT,p);
     }
@@ -0,0 +1,188 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  Profiler.cpp
+ *  @brief Implementation of the Profiler utility class
+ */
+
+#include "Profiler.h"
+#include "../include/assimp/scene.h"
+
+#include <chrono>
+#include <ctime>
+
+#ifdef _WIN32
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   include <psapi.h>
+#   ifdef _MSC_VER
+#       pragma comment(lib, "psapi.lib")
+#   endif
+#else
+#   include <sys/resource.h>
+#endif
+
+namespace Assimp    {
+namespace Profiling {
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::BeginRegion(const std::string& region, const aiScene* scene)
+{
+    unsigned int vertices, faces;
+    CountScene(scene, vertices, faces);
+    BeginRegion(region, vertices, faces);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::BeginRegion(const std::string& region, unsigned int vertices, unsigned int faces)
+{
+    Start& start = regions[region];
+    start.vertices = vertices;
+    start.faces = faces;
+    start.peak_memory = results ? GetPeakMemory() : 0;
+    start.cpu = results ? GetCpuTime() : 0.0;
+    start.wall = GetWallTime();
+
+    DefaultLogger::get()->debug((format("START `"),region,"`"));
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::EndRegion(const std::string& region, const aiScene* scene)
+{
+    unsigned int vertices, faces;
+    CountScene(scene, vertices, faces);
+    EndRegion(region, vertices, faces);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::EndRegion(const std::string& region, unsigned int vertices, unsigned int faces)
+{
+    const double wall = GetWallTime();
+
+    RegionMap::iterator it = regions.find(region);
+    if (it == regions.end()) {
+        return;
+    }
+
+    const Start& start = (*it).second;
+    DefaultLogger::get()->debug((format("END   `"),region,"`, dt= ",wall - start.wall," s"));
+
+    if (results) {
+        ProfileRegion r;
+        r.mName = region;
+        r.mWallTime = wall - start.wall;
+        r.mCpuTime = GetCpuTime() - start.cpu;
+        r.mPeakMemoryDelta = GetPeakMemory() - start.peak_memory;
+        r.mVerticesIn = start.vertices;
+        r.mFacesIn = start.faces;
+        r.mVerticesOut = vertices;
+        r.mFacesOut = faces;
+        results->push_back(r);
+    }
+    regions.erase(it);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::CountScene(const aiScene* scene, unsigned int& vertices, unsigned int& faces)
+{
+    vertices = faces = 0;
+    if (!scene) {
+        return;
+    }
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        vertices += scene->mMeshes[i]->mNumVertices;
+        faces += scene->mMeshes[i]->mNumFaces;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+double Profiler::GetWallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+double Profiler::GetCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    // 100ns units
+    const ULONGLONG k = (static_cast<ULONGLONG>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const ULONGLONG u = (static_cast<ULONGLONG>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return static_cast<double>(k + u) * 1e-7;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0.0;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t Profiler::GetPeakMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#   ifdef __APPLE__
+    // bytes on OS X, kilobytes everywhere else
+    return static_cast<size_t>(usage.ru_maxrss);
+#   else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#   endif
+#endif
+}
+
+} // Namespace Profiling
+} // Namespace Assimp
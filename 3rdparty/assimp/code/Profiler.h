@@ -44,12 +44,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_PROFILER_H
 #define INCLUDED_PROFILER_H
 
-#include "boost/timer.hpp"
 #include "../include/assimp/DefaultLogger.hpp"
+#include "../include/assimp/Profiling.hpp"
 #include "TinyFormatter.h"
 
 #include <map>
 
+struct aiScene;
+
 namespace Assimp {
     namespace Profiling {
 
@@ -57,39 +59,60 @@ namespace Assimp {
 
 
 // ------------------------------------------------------------------------------------------------
-/** Simple wrapper around boost::timer to simplify reporting. Timings are automatically
- *  dumped to the log file.
+/** Measures named regions of work. Wall times are dumped to the log file and, if
+ *  a result list is given, all measurements of a region are appended to it when
+ *  the region ends.
  */
 class Profiler
 {
 
 public:
 
-    Profiler() {}
+    /** @param results Receives a #ProfileRegion for each region ended, may be NULL */
+    explicit Profiler(ProfileRegionList* results = NULL)
+        : results(results)
+    {}
 
 public:
 
-    /** Start a named timer */
-    void BeginRegion(const std::string& region) {
-        regions[region] = boost::timer();
-        DefaultLogger::get()->debug((format("START `"),region,"`"));
-    }
+    /** Start a named timer, optionally counting the vertices and faces in a scene */
+    void BeginRegion(const std::string& region, const aiScene* scene = NULL);
 
+    /** Start a named timer with given vertex and face counts */
+    void BeginRegion(const std::string& region, unsigned int vertices, unsigned int faces);
 
     /** End a specific named timer and write its end time to the log */
-    void EndRegion(const std::string& region) {
-        RegionMap::const_iterator it = regions.find(region);
-        if (it == regions.end()) {
-            return;
-        }
+    void EndRegion(const std::string& region, const aiScene* scene = NULL);
 
-        DefaultLogger::get()->debug((format("END   `"),region,"`, dt= ",(*it).second.elapsed()," s"));
-    }
+    /** End a specific named timer with given vertex and face counts */
+    void EndRegion(const std::string& region, unsigned int vertices, unsigned int faces);
+
+public:
+
+    /** Get the total number of vertices and faces in all meshes of a scene */
+    static void CountScene(const aiScene* scene, unsigned int& vertices, unsigned int& faces);
+
+    /** Get the wall clock time, in seconds since an arbitrary point */
+    static double GetWallTime();
+
+    /** Get the processor time used by the process, in seconds */
+    static double GetCpuTime();
+
+    /** Get the peak resident set size of the process, in bytes */
+    static size_t GetPeakMemory();
 
 private:
 
-    typedef std::map<std::string,boost::timer> RegionMap;
+    struct Start {
+        double wall, cpu;
+        size_t peak_memory;
+        unsigned int vertices, faces;
+    };
+
+    typedef std::map<std::string,Start> RegionMap;
     RegionMap regions;
+
+    ProfileRegionList* results;
 };
 
     }
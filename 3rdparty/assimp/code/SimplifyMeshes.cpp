@@ -0,0 +1,702 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  SimplifyMeshes.cpp
+ *  @brief Implementation of the aiProcess_SimplifyMeshes step
+ */
+
+
+#ifndef ASSIMP_BUILD_NO_SIMPLIFYMESHES_PROCESS
+
+
+#include "SimplifyMeshes.h"
+#include "ProcessHelper.h"
+#include "../include/assimp/postprocess.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <stdio.h>
+
+using namespace Assimp;
+
+namespace {
+
+// border planes count more than face planes to keep the outline of open meshes
+const double kBorderWeight = 10.0;
+
+// a collapse must not turn a triangle by more than ~75 degrees
+const float kFlipThreshold = 0.25f;
+
+// ------------------------------------------------------------------------------------------------
+struct Collapse
+{
+    double cost;
+
+    // squared distance part of the cost
+    double error;
+    unsigned int v, t;
+
+    bool operator < (const Collapse& other) const {
+        return cost < other.cost;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+inline uint64_t EdgeKey(unsigned int a, unsigned int b)
+{
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Orders vertex indices by the position of the vertices
+struct PositionLess
+{
+    explicit PositionLess(const aiVector3D* positions)
+        : positions(positions)
+    {}
+
+    bool operator () (unsigned int a, unsigned int b) const {
+        return positions[a] < positions[b];
+    }
+
+    const aiVector3D* positions;
+};
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+SimplifyMeshesProcess::SimplifyMeshesProcess()
+    : mTargetRatio(0.5f)
+    , mMaxError(0.01f)
+    , mNormalWeight(0.05f)
+    , mTexCoordWeight(0.5f)
+    , mAttributeScale()
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+SimplifyMeshesProcess::~SimplifyMeshesProcess()
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool SimplifyMeshesProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_SimplifyMeshes) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup properties for the postprocessing step
+void SimplifyMeshesProcess::SetupProperties(const Importer* pImp)
+{
+    mTargetRatio = pImp->GetPropertyFloat(AI_CONFIG_PP_SM_TARGET_RATIO,0.5f);
+    mMaxError = pImp->GetPropertyFloat(AI_CONFIG_PP_SM_MAX_ERROR,0.01f);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void SimplifyMeshesProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("SimplifyMeshesProcess begin");
+
+    std::vector<unsigned int> facesBefore(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int i) {
+        aiMesh* const mesh = pScene->mMeshes[i];
+        facesBefore[i] = mesh->mNumFaces;
+
+        // the error limit is relative to the size of the mesh
+        aiVector3D min, max;
+        ArrayBounds(mesh->mVertices, mesh->mNumVertices, min, max);
+        const unsigned int target = static_cast<unsigned int>(mesh->mNumFaces * mTargetRatio);
+
+        // the scratch data lives in the simplifier, so each mesh gets its own
+        SimplifyMeshesProcess simplifier;
+        simplifier.SetAttributeWeights(mNormalWeight, mTexCoordWeight);
+
+        float error;
+        aiMesh* const result = simplifier.SimplifyMesh(mesh, target, mMaxError * (max - min).Length(), error);
+        if (result) {
+            delete mesh;
+            pScene->mMeshes[i] = result;
+        }
+    });
+
+    unsigned int before = 0, after = 0;
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        before += facesBefore[i];
+        after += pScene->mMeshes[i]->mNumFaces;
+    }
+
+    char szBuffer[128];
+    ::sprintf(szBuffer,"SimplifyMeshesProcess finished. Reduced %u faces to %u",before,after);
+    DefaultLogger::get()->info(szBuffer);
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMesh* SimplifyMeshesProcess::SimplifyMesh(const aiMesh* mesh, unsigned int targetFaces, float maxError, float& error)
+{
+    error = 0.f;
+    if (!mesh->mNumFaces || targetFaces >= mesh->mNumFaces || mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE ||
+        mesh->mNumAnimMeshes) {
+        return NULL;
+    }
+
+    mIndices.resize(mesh->mNumFaces * 3);
+    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+        const aiFace& face = mesh->mFaces[i];
+        if (face.mNumIndices != 3) {
+            return NULL;
+        }
+        std::copy(face.mIndices, face.mIndices + 3, &mIndices[i * 3]);
+    }
+
+    const unsigned int numVertices = mesh->mNumVertices;
+    aiVector3D min, max;
+    ArrayBounds(mesh->mVertices, numVertices, min, max);
+    mAttributeScale = (max - min).SquareLength();
+
+    ClassifyVertices(mesh);
+    ComputeQuadrics(mesh);
+
+    mRemap.resize(numVertices);
+    for (unsigned int i = 0; i < numVertices; ++i) {
+        mRemap[i] = i;
+    }
+
+    const double maxSquaredError = static_cast<double>(maxError) * maxError;
+    double worst = 0.0;
+
+    std::vector<Collapse> collapses;
+    std::vector<bool> touched;
+
+    // collapse in passes: find the cheapest collapse for each edge, then perform
+    // them in order of their cost as long as they don't overlap. At least one
+    // face is always left.
+    targetFaces = std::max(targetFaces, 1u);
+    unsigned int numFaces = mesh->mNumFaces;
+    while (numFaces > targetFaces) {
+        BuildAdjacency(numVertices);
+
+        collapses.clear();
+        for (size_t i = 0; i < mIndices.size(); ++i) {
+            const unsigned int a = mIndices[i], b = mIndices[i % 3 == 2 ? i - 2 : i + 1];
+
+            Collapse c;
+            c.cost = std::numeric_limits<double>::max();
+            if (CanCollapse(a, b)) {
+                c.cost = GetCollapseCost(mesh, a, b, c.error);
+                c.v = a;
+                c.t = b;
+            }
+            if (CanCollapse(b, a)) {
+                double reverseError;
+                const double cost = GetCollapseCost(mesh, b, a, reverseError);
+                if (cost < c.cost) {
+                    c.cost = cost;
+                    c.error = reverseError;
+                    c.v = b;
+                    c.t = a;
+                }
+            }
+            if (c.cost != std::numeric_limits<double>::max() && c.error <= maxSquaredError) {
+                collapses.push_back(c);
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end());
+
+        touched.assign(numVertices, false);
+        const unsigned int budget = numFaces - targetFaces;
+        unsigned int removed = 0, performed = 0;
+
+        for (std::vector<Collapse>::const_iterator it = collapses.begin(); it != collapses.end() && removed < budget; ++it) {
+            const Collapse& c = *it;
+            if (touched[c.v] || touched[c.t]) {
+                continue;
+            }
+
+            // seam vertices move together with their twins
+            const bool seam = mKinds[c.v] == Kind_Seam;
+            const unsigned int tv = seam ? mTwins[c.v] : 0, tt = seam ? mTwins[c.t] : 0;
+            if (seam && (touched[tv] || touched[tt])) {
+                continue;
+            }
+
+            const unsigned int faces = CountSharedFaces(c.v, c.t) + (seam ? CountSharedFaces(tv, tt) : 0);
+            if (faces > budget - removed || !IsCollapseValid(mesh, c.v, c.t) || (seam && !IsCollapseValid(mesh, tv, tt))) {
+                continue;
+            }
+
+            ApplyCollapse(c.v, c.t, touched);
+            if (seam) {
+                ApplyCollapse(tv, tt, touched);
+            }
+
+            removed += faces;
+            worst = std::max(worst, c.error);
+            ++performed;
+        }
+        if (!performed) {
+            break;
+        }
+        numFaces = CompactIndices();
+    }
+
+    if (numFaces == mesh->mNumFaces) {
+        return NULL;
+    }
+
+    error = static_cast<float>(std::sqrt(worst));
+    return BuildMesh(mesh);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::ClassifyVertices(const aiMesh* mesh)
+{
+    const unsigned int numVertices = mesh->mNumVertices;
+    mKinds.assign(numVertices, Kind_Manifold);
+
+    mEdges.resize(mIndices.size());
+    for (size_t i = 0; i < mIndices.size(); ++i) {
+        mEdges[i] = EdgeKey(mIndices[i], mIndices[i % 3 == 2 ? i - 2 : i + 1]);
+    }
+    std::sort(mEdges.begin(), mEdges.end());
+
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+        const unsigned int a = static_cast<unsigned int>(mEdges[i] >> 32), b = static_cast<unsigned int>(mEdges[i]);
+
+        // an edge used twice in the same direction is non-manifold
+        if (i + 1 < mEdges.size() && mEdges[i] == mEdges[i + 1]) {
+            mKinds[a] = mKinds[b] = Kind_Locked;
+        }
+        // an edge without its opposite is on a border
+        else if (!std::binary_search(mEdges.begin(), mEdges.end(), EdgeKey(b, a))) {
+            mKinds[a] = std::max<unsigned char>(mKinds[a], Kind_Border);
+            mKinds[b] = std::max<unsigned char>(mKinds[b], Kind_Border);
+        }
+    }
+
+    // vertices sharing their position with others lie on a seam of normals or
+    // texture coordinates. Moving one of them alone would tear the surface apart.
+    std::vector<unsigned int> order(numVertices);
+    for (unsigned int i = 0; i < numVertices; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), PositionLess(mesh->mVertices));
+
+    // two vertices on a border can move along their seam, more can't
+    mTwins.assign(numVertices, UINT_MAX);
+    for (unsigned int i = 0, j; i < numVertices; i = j) {
+        for (j = i + 1; j < numVertices && mesh->mVertices[order[i]] == mesh->mVertices[order[j]]; ++j) {
+        }
+
+        if (j - i == 2 && mKinds[order[i]] == Kind_Border && mKinds[order[i + 1]] == Kind_Border) {
+            mKinds[order[i]] = mKinds[order[i + 1]] = Kind_Seam;
+            mTwins[order[i]] = order[i + 1];
+            mTwins[order[i + 1]] = order[i];
+        }
+        else if (j - i > 1) {
+            for (unsigned int k = i; k < j; ++k) {
+                mKinds[order[k]] = Kind_Locked;
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::ComputeQuadrics(const aiMesh* mesh)
+{
+    mQuadrics.resize(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        mQuadrics[i].Clear();
+    }
+
+    for (size_t i = 0; i < mIndices.size(); i += 3) {
+        const unsigned int* const tri = &mIndices[i];
+        const aiVector3D& p0 = mesh->mVertices[tri[0]];
+        const aiVector3D& p1 = mesh->mVertices[tri[1]];
+        const aiVector3D& p2 = mesh->mVertices[tri[2]];
+
+        aiVector3D normal = (p1 - p0) ^ (p2 - p0);
+        const float length = normal.Length();
+        if (length == 0.f) {
+            continue;
+        }
+        normal /= length;
+
+        // face planes are weighted by the area of the face
+        const double area = length * 0.5;
+        for (unsigned int k = 0; k < 3; ++k) {
+            mQuadrics[tri[k]].AddPlane(normal, -(normal * p0), area);
+        }
+
+        // border edges add a plane perpendicular to the face, which keeps
+        // the vertices on the border from moving away from it
+        for (unsigned int k = 0; k < 3; ++k) {
+            const unsigned int a = tri[k], b = tri[(k + 1) % 3];
+            if (std::binary_search(mEdges.begin(), mEdges.end(), EdgeKey(b, a))) {
+                continue;
+            }
+
+            const aiVector3D edge = mesh->mVertices[b] - mesh->mVertices[a];
+            aiVector3D side = edge ^ normal;
+            const float side_length = side.Length();
+            if (side_length == 0.f) {
+                continue;
+            }
+            side /= side_length;
+
+            const double weight = edge.SquareLength() * kBorderWeight;
+            mQuadrics[a].AddPlane(side, -(side * mesh->mVertices[a]), weight);
+            mQuadrics[b].AddPlane(side, -(side * mesh->mVertices[a]), weight);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::BuildAdjacency(unsigned int numVertices)
+{
+    mAdjacencyOffsets.assign(numVertices + 1, 0);
+    for (size_t i = 0; i < mIndices.size(); ++i) {
+        ++mAdjacencyOffsets[mIndices[i] + 1];
+    }
+    for (unsigned int i = 0; i < numVertices; ++i) {
+        mAdjacencyOffsets[i + 1] += mAdjacencyOffsets[i];
+    }
+
+    mAdjacency.resize(mIndices.size());
+    std::vector<unsigned int> fill(mAdjacencyOffsets.begin(), mAdjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < mIndices.size(); ++i) {
+        mAdjacency[fill[mIndices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SimplifyMeshesProcess::CanCollapse(unsigned int v, unsigned int t) const
+{
+    switch (mKinds[v]) {
+    case Kind_Manifold:
+        return true;
+    case Kind_Border:
+        // only along the border, onto another vertex on it
+        return mKinds[t] != Kind_Manifold && CountSharedFaces(v, t) == 1;
+    case Kind_Seam:
+        // only along the seam, with the twins on an edge of the other side
+        return mKinds[t] == Kind_Seam && mTwins[v] != t && CountSharedFaces(v, t) == 1 &&
+            CountSharedFaces(mTwins[v], mTwins[t]) == 1;
+    default:
+        return false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+double SimplifyMeshesProcess::GetCollapseCost(const aiMesh* mesh, unsigned int v, unsigned int t, double& error) const
+{
+    double cost = GetVertexCollapseCost(mesh, v, t, error);
+    if (mKinds[v] == Kind_Seam) {
+        double twinError;
+        cost += GetVertexCollapseCost(mesh, mTwins[v], mTwins[t], twinError);
+        error = std::max(error, twinError);
+    }
+    return cost;
+}
+
+// ------------------------------------------------------------------------------------------------
+double SimplifyMeshesProcess::GetVertexCollapseCost(const aiMesh* mesh, unsigned int v, unsigned int t, double& error) const
+{
+    Quadric q = mQuadrics[v];
+    q.Add(mQuadrics[t]);
+
+    // mean squared distance to the merged planes
+    error = q.w > 0.0 ? std::max(q.Evaluate(mesh->mVertices[t]) / q.w, 0.0) : 0.0;
+    double cost = error;
+
+    if (mesh->HasNormals()) {
+        const double weight = mAttributeScale * mNormalWeight * mNormalWeight;
+        cost += weight * (mesh->mNormals[v] - mesh->mNormals[t]).SquareLength();
+    }
+    for (unsigned int k = 0; mesh->HasTextureCoords(k); ++k) {
+        const double weight = mAttributeScale * mTexCoordWeight * mTexCoordWeight;
+        cost += weight * (mesh->mTextureCoords[k][v] - mesh->mTextureCoords[k][t]).SquareLength();
+    }
+    return cost;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SimplifyMeshesProcess::IsCollapseValid(const aiMesh* mesh, unsigned int v, unsigned int t)
+{
+    // the vertices next to both v and t must be exactly the third vertices of the
+    // faces on the edge, otherwise the collapse would create non-manifold edges
+    GetNeighbours(v, mNeighboursV);
+    GetNeighbours(t, mNeighboursT);
+
+    unsigned int shared = 0;
+    for (std::vector<unsigned int>::const_iterator it = mNeighboursV.begin(); it != mNeighboursV.end(); ++it) {
+        shared += *it != t && std::binary_search(mNeighboursT.begin(), mNeighboursT.end(), *it);
+    }
+    if (shared != CountSharedFaces(v, t)) {
+        return false;
+    }
+
+    // no face may flip over or get too close to it
+    for (unsigned int j = mAdjacencyOffsets[v]; j < mAdjacencyOffsets[v + 1]; ++j) {
+        const unsigned int* const tri = &mIndices[mAdjacency[j] * 3];
+        if (tri[0] == t || tri[1] == t || tri[2] == t) {
+            continue;
+        }
+
+        aiVector3D p[3], q[3];
+        for (unsigned int k = 0; k < 3; ++k) {
+            p[k] = mesh->mVertices[tri[k]];
+            q[k] = mesh->mVertices[tri[k] == v ? t : tri[k]];
+        }
+
+        const aiVector3D before = (p[1] - p[0]) ^ (p[2] - p[0]);
+        const aiVector3D after = (q[1] - q[0]) ^ (q[2] - q[0]);
+        const float lengths = before.Length() * after.Length();
+        if (lengths > 0.f && before * after < kFlipThreshold * lengths) {
+            return false;
+        }
+        if (lengths == 0.f && before.SquareLength() > 0.f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::ApplyCollapse(unsigned int v, unsigned int t, std::vector<bool>& touched)
+{
+    // faces around v change, so their vertices are done for this pass
+    for (unsigned int j = mAdjacencyOffsets[v]; j < mAdjacencyOffsets[v + 1]; ++j) {
+        const unsigned int* const tri = &mIndices[mAdjacency[j] * 3];
+        touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+    }
+
+    mRemap[v] = t;
+    mQuadrics[t].Add(mQuadrics[v]);
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int SimplifyMeshesProcess::CountSharedFaces(unsigned int v, unsigned int t) const
+{
+    unsigned int count = 0;
+    for (unsigned int j = mAdjacencyOffsets[v]; j < mAdjacencyOffsets[v + 1]; ++j) {
+        const unsigned int* const tri = &mIndices[mAdjacency[j] * 3];
+        count += tri[0] == t || tri[1] == t || tri[2] == t;
+    }
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::GetNeighbours(unsigned int v, std::vector<unsigned int>& out) const
+{
+    out.clear();
+    for (unsigned int j = mAdjacencyOffsets[v]; j < mAdjacencyOffsets[v + 1]; ++j) {
+        const unsigned int* const tri = &mIndices[mAdjacency[j] * 3];
+        for (unsigned int k = 0; k < 3; ++k) {
+            if (tri[k] != v) {
+                out.push_back(tri[k]);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+// Apply the collapses of the last pass to the index buffer and drop the faces
+// they made degenerate. Returns the number of remaining faces.
+unsigned int SimplifyMeshesProcess::CompactIndices()
+{
+    size_t out = 0;
+    for (size_t i = 0; i < mIndices.size(); i += 3) {
+        const unsigned int a = mRemap[mIndices[i]], b = mRemap[mIndices[i + 1]], c = mRemap[mIndices[i + 2]];
+        if (a != b && b != c && c != a) {
+            mIndices[out++] = a;
+            mIndices[out++] = b;
+            mIndices[out++] = c;
+        }
+    }
+    mIndices.resize(out);
+    return static_cast<unsigned int>(out / 3);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Build a mesh of the remaining faces and the vertices they use
+aiMesh* SimplifyMeshesProcess::BuildMesh(const aiMesh* mesh) const
+{
+    // vertices are numbered in order of their first use
+    std::vector<unsigned int> map(mesh->mNumVertices, UINT_MAX);
+    std::vector<unsigned int> source;
+    for (size_t i = 0; i < mIndices.size(); ++i) {
+        if (map[mIndices[i]] == UINT_MAX) {
+            map[mIndices[i]] = static_cast<unsigned int>(source.size());
+            source.push_back(mIndices[i]);
+        }
+    }
+
+    aiMesh* const out = new aiMesh();
+    out->mName = mesh->mName;
+    out->mMaterialIndex = mesh->mMaterialIndex;
+    out->mPrimitiveTypes = mesh->mPrimitiveTypes;
+    out->mNumVertices = static_cast<unsigned int>(source.size());
+
+    // copy each stream the mesh has
+    aiVector3D* const* const in_vectors[] = { &mesh->mVertices, &mesh->mNormals, &mesh->mTangents, &mesh->mBitangents };
+    aiVector3D** const out_vectors[] = { &out->mVertices, &out->mNormals, &out->mTangents, &out->mBitangents };
+    for (unsigned int k = 0; k < 4; ++k) {
+        if (*in_vectors[k]) {
+            *out_vectors[k] = new aiVector3D[out->mNumVertices];
+            for (unsigned int i = 0; i < out->mNumVertices; ++i) {
+                (*out_vectors[k])[i] = (*in_vectors[k])[source[i]];
+            }
+        }
+    }
+    for (unsigned int k = 0; mesh->HasVertexColors(k); ++k) {
+        out->mColors[k] = new aiColor4D[out->mNumVertices];
+        for (unsigned int i = 0; i < out->mNumVertices; ++i) {
+            out->mColors[k][i] = mesh->mColors[k][source[i]];
+        }
+    }
+    for (unsigned int k = 0; mesh->HasTextureCoords(k); ++k) {
+        out->mNumUVComponents[k] = mesh->mNumUVComponents[k];
+        out->mTextureCoords[k] = new aiVector3D[out->mNumVertices];
+        for (unsigned int i = 0; i < out->mNumVertices; ++i) {
+            out->mTextureCoords[k][i] = mesh->mTextureCoords[k][source[i]];
+        }
+    }
+
+    out->mNumFaces = static_cast<unsigned int>(mIndices.size() / 3);
+    out->mFaces = new aiFace[out->mNumFaces];
+    for (unsigned int i = 0; i < out->mNumFaces; ++i) {
+        aiFace& face = out->mFaces[i];
+        face.mNumIndices = 3;
+        face.mIndices = new unsigned int[3];
+        for (unsigned int k = 0; k < 3; ++k) {
+            face.mIndices[k] = map[mIndices[i * 3 + k]];
+        }
+    }
+
+    // bones keep the weights of the remaining vertices, bones left without any are dropped
+    std::vector<aiBone*> bones;
+    for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+        const aiBone* const bone = mesh->mBones[b];
+
+        std::vector<aiVertexWeight> weights;
+        for (unsigned int i = 0; i < bone->mNumWeights; ++i) {
+            const aiVertexWeight& w = bone->mWeights[i];
+            if (map[w.mVertexId] != UINT_MAX) {
+                weights.push_back(aiVertexWeight(map[w.mVertexId], w.mWeight));
+            }
+        }
+        if (weights.empty()) {
+            continue;
+        }
+
+        aiBone* const copy = new aiBone();
+        copy->mName = bone->mName;
+        copy->mOffsetMatrix = bone->mOffsetMatrix;
+        copy->mNumWeights = static_cast<unsigned int>(weights.size());
+        copy->mWeights = new aiVertexWeight[copy->mNumWeights];
+        std::copy(weights.begin(), weights.end(), copy->mWeights);
+        bones.push_back(copy);
+    }
+    if (!bones.empty()) {
+        out->mNumBones = static_cast<unsigned int>(bones.size());
+        out->mBones = new aiBone*[out->mNumBones];
+        std::copy(bones.begin(), bones.end(), out->mBones);
+    }
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::Quadric::Clear()
+{
+    a00 = a11 = a22 = a01 = a02 = a12 = b0 = b1 = b2 = c = w = 0.0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::Quadric::AddPlane(const aiVector3D& n, double d, double weight)
+{
+    a00 += weight * n.x * n.x;
+    a11 += weight * n.y * n.y;
+    a22 += weight * n.z * n.z;
+    a01 += weight * n.x * n.y;
+    a02 += weight * n.x * n.z;
+    a12 += weight * n.y * n.z;
+    b0 += weight * n.x * d;
+    b1 += weight * n.y * d;
+    b2 += weight * n.z * d;
+    c += weight * d * d;
+    w += weight;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SimplifyMeshesProcess::Quadric::Add(const Quadric& o)
+{
+    a00 += o.a00; a11 += o.a11; a22 += o.a22;
+    a01 += o.a01; a02 += o.a02; a12 += o.a12;
+    b0 += o.b0; b1 += o.b1; b2 += o.b2;
+    c += o.c;
+    w += o.w;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Sum of the weighted squared distances of p to all planes
+double SimplifyMeshesProcess::Quadric::Evaluate(const aiVector3D& p) const
+{
+    const double x = p.x, y = p.y, z = p.z;
+    return a00 * x * x + a11 * y * y + a22 * z * z
+        + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+        + 2.0 * (b0 * x + b1 * y + b2 * z)
+        + c;
+}
+
+#endif // !! ASSIMP_BUILD_NO_SIMPLIFYMESHES_PROCESS
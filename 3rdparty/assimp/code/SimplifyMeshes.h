@@ -0,0 +1,180 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file  SimplifyMeshes.h
+ *  @brief Declares a post processing step to reduce the triangle count of meshes
+ */
+#ifndef AI_SIMPLIFYMESHESPROCESS_H_INC
+#define AI_SIMPLIFYMESHESPROCESS_H_INC
+
+#include "BaseProcess.h"
+#include "../include/assimp/vector3.h"
+#include <stdint.h>
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp    {
+
+// ---------------------------------------------------------------------------
+/** @brief Postprocessing step to simplify meshes by edge collapses.
+ *
+ *  Each collapse moves one vertex onto a neighbour (half-edge collapse), so
+ *  the output uses a subset of the input vertices with their attributes
+ *  unchanged. Collapses are ordered by their cost: the quadric error of the
+ *  planes of all triangles merged into the remaining vertex, plus a weighted
+ *  difference of the normals and texture coordinates of both vertices.
+ *
+ *  SimplifyMesh() is usable on its own to get simplified copies of a mesh,
+ *  i.e. to build a chain of levels of detail.
+ */
+class SimplifyMeshesProcess : public BaseProcess
+{
+public:
+
+    SimplifyMeshesProcess();
+    ~SimplifyMeshesProcess();
+
+public:
+    // -------------------------------------------------------------------
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    void Execute( aiScene* pScene);
+
+    // -------------------------------------------------------------------
+    void SetupProperties(const Importer* pImp);
+
+public:
+
+    // -------------------------------------------------------------------
+    /** @brief Get a simplified copy of a mesh.
+     *
+     *  @param mesh Mesh to simplify, made of triangles only.
+     *  @param targetFaces Number of faces to reduce the mesh to.
+     *  @param maxError Largest error to accept, in units of the mesh's
+     *    positions. Simplification stops early where the next collapse
+     *    would exceed it.
+     *  @param error Receives the error of the result, a distance in units
+     *    of the mesh's positions.
+     *  @return The simplified mesh, NULL if the mesh could not be
+     *    simplified at all.
+     */
+    aiMesh* SimplifyMesh(const aiMesh* mesh, unsigned int targetFaces, float maxError, float& error);
+
+    // -------------------------------------------------------------------
+    /** @brief Set how much differences of normals and texture coordinates
+     *  count towards the cost of a collapse.
+     *
+     *  The weights scale the length of the difference vectors into a
+     *  fraction of the size of the mesh, i.e. with a normal weight of 0.05
+     *  a collapse onto a vertex whose normal differs by 1 costs as much as
+     *  moving the surface by 5% of the mesh size.
+     */
+    void SetAttributeWeights(float normals, float texcoords) {
+        mNormalWeight = normals;
+        mTexCoordWeight = texcoords;
+    }
+
+private:
+
+    // -------------------------------------------------------------------
+    /** Symmetric 4x4 matrix of a sum of squared plane distances */
+    struct Quadric
+    {
+        double a00, a11, a22, a01, a02, a12, b0, b1, b2, c, w;
+
+        void Clear();
+        void AddPlane(const aiVector3D& normal, double d, double weight);
+        void Add(const Quadric& other);
+        double Evaluate(const aiVector3D& p) const;
+    };
+
+    /** What a vertex may be collapsed onto */
+    enum VertexKind
+    {
+        Kind_Manifold,  //!< interior vertex, onto any neighbour
+        Kind_Border,    //!< on an open border, only along the border
+        Kind_Seam,      //!< one of two vertices at the same position, only
+                        //!< along the seam and together with its twin
+        Kind_Locked     //!< on a non-manifold edge or where more than two
+                        //!< vertices meet, not at all
+    };
+
+    void ClassifyVertices(const aiMesh* mesh);
+    void ComputeQuadrics(const aiMesh* mesh);
+    void BuildAdjacency(unsigned int numVertices);
+
+    bool CanCollapse(unsigned int v, unsigned int t) const;
+    double GetCollapseCost(const aiMesh* mesh, unsigned int v, unsigned int t, double& error) const;
+    double GetVertexCollapseCost(const aiMesh* mesh, unsigned int v, unsigned int t, double& error) const;
+    bool IsCollapseValid(const aiMesh* mesh, unsigned int v, unsigned int t);
+    void ApplyCollapse(unsigned int v, unsigned int t, std::vector<bool>& touched);
+    unsigned int CountSharedFaces(unsigned int v, unsigned int t) const;
+    void GetNeighbours(unsigned int v, std::vector<unsigned int>& out) const;
+
+    unsigned int CompactIndices();
+    aiMesh* BuildMesh(const aiMesh* mesh) const;
+
+private:
+
+    //! Configuration
+    float mTargetRatio;
+    float mMaxError;
+    float mNormalWeight;
+    float mTexCoordWeight;
+
+    //! Per mesh scratch data, see SimplifyMesh()
+    std::vector<unsigned int> mIndices;
+    std::vector<uint64_t> mEdges;
+    std::vector<unsigned char> mKinds;
+    std::vector<unsigned int> mTwins;
+    std::vector<Quadric> mQuadrics;
+    std::vector<unsigned int> mRemap;
+    std::vector<unsigned int> mAdjacencyOffsets;
+    std::vector<unsigned int> mAdjacency;
+    std::vector<unsigned int> mNeighboursV, mNeighboursT;
+    double mAttributeScale;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_SIMPLIFYMESHESPROCESS_H_INC
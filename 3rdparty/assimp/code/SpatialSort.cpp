@@ -44,6 +44,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SpatialSort.h"
 #include <boost/static_assert.hpp>
 #include "../include/assimp/ai_assert.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#   define AI_SPATIALSORT_SSE
+#   include <xmmintrin.h>
+#endif
 
 using namespace Assimp;
 
@@ -52,6 +60,133 @@ using namespace Assimp;
 #   define CHAR_BIT 8
 #endif
 
+namespace {
+
+    // Binary, signed-integer representation of a single-precision floating-point value.
+    // IEEE 754 says: "If two floating-point numbers in the same format are ordered then they are
+    //  ordered the same way when their bits are reinterpreted as sign-magnitude integers."
+    // This allows us to convert all floating-point numbers to signed integers of arbitrary size
+    //  and then use them to work with ULPs (Units in the Last Place, for high-precision
+    //  computations) or to compare them (integer comparisons are faster than floating-point
+    //  comparisons on many platforms).
+    typedef signed int BinFloat;
+
+    // --------------------------------------------------------------------------------------------
+    // Converts the bit pattern of a floating-point number to its signed integer representation.
+    BinFloat ToBinary( const float & pValue) {
+
+        // If this assertion fails, signed int is not big enough to store a float on your platform.
+        //  Please correct the declaration of BinFloat a few lines above - but do it in a portable,
+        //  #ifdef'd manner!
+        BOOST_STATIC_ASSERT( sizeof(BinFloat) >= sizeof(float));
+
+        #if defined( _MSC_VER)
+            // If this assertion fails, Visual C++ has finally moved to ILP64. This means that this
+            //  code has just become legacy code! Find out the current value of _MSC_VER and modify
+            //  the #if above so it evaluates false on the current and all upcoming VC versions (or
+            //  on the current platform, if LP64 or LLP64 are still used on other platforms).
+            BOOST_STATIC_ASSERT( sizeof(BinFloat) == sizeof(float));
+
+            // This works best on Visual C++, but other compilers have their problems with it.
+            const BinFloat binValue = reinterpret_cast<BinFloat const &>(pValue);
+        #else
+            // On many compilers, reinterpreting a float address as an integer causes aliasing
+            // problems. This is an ugly but more or less safe way of doing it.
+            union {
+                float       asFloat;
+                BinFloat    asBin;
+            } conversion;
+            conversion.asBin    = 0; // zero empty space in case sizeof(BinFloat) > sizeof(float)
+            conversion.asFloat  = pValue;
+            const BinFloat binValue = conversion.asBin;
+        #endif
+
+        // floating-point numbers are of sign-magnitude format, so find out what signed number
+        //  representation we must convert negative values to.
+        // See http://en.wikipedia.org/wiki/Signed_number_representations.
+
+        // Two's complement?
+        if( (-42 == (~42 + 1)) && (binValue & 0x80000000))
+            return BinFloat(1 << (CHAR_BIT * sizeof(BinFloat) - 1)) - binValue;
+        // One's complement?
+        else if( (-42 == ~42) && (binValue & 0x80000000))
+            return BinFloat(-0) - binValue;
+        // Sign-magnitude?
+        else if( (-42 == (42 | (-0))) && (binValue & 0x80000000)) // -0 = 1000... binary
+            return binValue;
+        else
+            return binValue;
+    }
+
+} // namespace
+namespace {
+
+    // --------------------------------------------------------------------------------------------
+    // Maps a float to an unsigned integer of the same order, for radix sorting.
+    inline uint32_t ToRadixKey( float pValue) {
+        uint32_t bits;
+        ::memcpy( &bits, &pValue, sizeof(bits));
+        return bits ^ ((bits & 0x80000000) ? 0xffffffff : 0x80000000);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    // Stable LSD radix sort in three passes of 11 bits. Gets the order in which to visit
+    // the keys for them to ascend.
+    void RadixSort( const std::vector<float>& pKeys, std::vector<unsigned int>& poOrder) {
+        const unsigned int num = (unsigned int)pKeys.size();
+        std::vector<uint32_t> keys( num), keysTemp( num);
+        std::vector<unsigned int> orderTemp( num);
+        poOrder.resize( num);
+        if( !num)
+            return;
+
+        // all histograms in one go
+        std::vector<unsigned int> histogram( 3 * 2048, 0);
+        for( unsigned int i = 0; i < num; ++i) {
+            const uint32_t key = ToRadixKey( pKeys[i]);
+            keys[i] = key;
+            poOrder[i] = i;
+            ++histogram[key & 0x7ff];
+            ++histogram[2048 + ((key >> 11) & 0x7ff)];
+            ++histogram[4096 + (key >> 22)];
+        }
+
+        for( unsigned int pass = 0; pass < 3; ++pass) {
+            const unsigned int shift = pass * 11;
+            unsigned int* const digits = &histogram[pass * 2048];
+
+            // nothing to do if all keys share this digit
+            if( digits[(keys[0] >> shift) & 0x7ff] == num)
+                continue;
+
+            unsigned int sum = 0;
+            for( unsigned int d = 0; d < 2048; ++d) {
+                const unsigned int count = digits[d];
+                digits[d] = sum;
+                sum += count;
+            }
+            for( unsigned int i = 0; i < num; ++i) {
+                const unsigned int slot = digits[(keys[i] >> shift) & 0x7ff]++;
+                keysTemp[slot] = keys[i];
+                orderTemp[slot] = poOrder[i];
+            }
+            keys.swap( keysTemp);
+            poOrder.swap( orderTemp);
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+    template <typename T>
+    void Gather( std::vector<T>& pData, const std::vector<unsigned int>& pOrder) {
+        std::vector<T> out( pOrder.size());
+        for( size_t i = 0; i < pOrder.size(); ++i) {
+            out[i] = pData[pOrder[i]];
+        }
+        pData.swap( out);
+    }
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructs a spatially sorted representation from the given position array.
 SpatialSort::SpatialSort( const aiVector3D* pPositions, unsigned int pNumPositions,
@@ -85,13 +220,31 @@ void SpatialSort::Fill( const aiVector3D* pPositions, unsigned int pNumPositions
     bool pFinalize /*= true */)
 {
     mPositions.clear();
+    mDistances.clear();
+    mCellStart.clear();
     Append(pPositions,pNumPositions,pElementOffset,pFinalize);
 }
 
 // ------------------------------------------------------------------------------------------------
 void SpatialSort :: Finalize()
 {
-    std::sort( mPositions.begin(), mPositions.end());
+    mCellStart.clear();
+    if (AI_SPATIALSORT_GRID_THRESHOLD && mPositions.size() >= AI_SPATIALSORT_GRID_THRESHOLD) {
+        BuildGrid();
+        return;
+    }
+
+    // sort the arrays ascending by distance
+    std::vector<unsigned int> order;
+    RadixSort( mDistances, order);
+    Reorder( order);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialSort :: Reorder(const std::vector<unsigned int>& order)
+{
+    Gather( mPositions, order);
+    Gather( mDistances, order);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -101,23 +254,155 @@ void SpatialSort::Append( const aiVector3D* pPositions, unsigned int pNumPositio
 {
     // store references to all given positions along with their distance to the reference plane
     const size_t initial = mPositions.size();
-    mPositions.reserve(initial + (pFinalize?pNumPositions:pNumPositions*2));
+    const size_t total = initial + pNumPositions;
+    mPositions.resize( total);
+    mDistances.resize( total);
     for( unsigned int a = 0; a < pNumPositions; a++)
     {
         const char* tempPointer = reinterpret_cast<const char*> (pPositions);
         const aiVector3D* vec   = reinterpret_cast<const aiVector3D*> (tempPointer + a * pElementOffset);
 
         // store position by index and distance
-        float distance = *vec * mPlaneNormal;
-        mPositions.push_back( Entry( a+initial, *vec, distance));
+        Entry& entry = mPositions[initial + a];
+        entry.mPosition[0] = vec->x;
+        entry.mPosition[1] = vec->y;
+        entry.mPosition[2] = vec->z;
+        entry.mIndex = (unsigned int)(initial + a);
+        mDistances[initial + a] = *vec * mPlaneNormal;
     }
 
     if (pFinalize) {
-        // now sort the array ascending by distance.
         Finalize();
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void SpatialSort :: BuildGrid()
+{
+    const unsigned int num = (unsigned int)mPositions.size();
+
+    // bounding box, NaNs are left out by the comparisons
+    float extent[3];
+    for( unsigned int a = 0; a < 3; ++a) {
+        float mn = 1e10f, mx = -1e10f;
+        for( unsigned int i = 0; i < num; ++i) {
+            const float c = mPositions[i].mPosition[a];
+            if( c < mn) mn = c;
+            if( c > mx) mx = c;
+        }
+        mGridMin[a] = mn;
+        extent[a] = mx > mn ? mx - mn : 0.f;
+    }
+
+    // pick the cell size for about two positions per cell over the axes the positions
+    // spread along, then grow it until the flat axes don't blow up the number of cells
+    unsigned int spread = 0;
+    double volume = 1.0;
+    for( unsigned int a = 0; a < 3; ++a) {
+        if( extent[a] > 0.f) {
+            volume *= extent[a];
+            ++spread;
+        }
+    }
+    double cellSize = spread ? std::pow( volume * 2.0 / num, 1.0 / spread) : 1.0;
+    for(;;) {
+        double cells = 1.0;
+        for( unsigned int a = 0; a < 3; ++a) {
+            const double size = extent[a] > 0.f ? std::ceil( extent[a] / cellSize) : 1.0;
+            mGridSize[a] = size < 1.0 ? 1 : (unsigned int)std::min( size, 1048576.0);
+            cells *= size;
+        }
+        if( cells <= num + 8.0)
+            break;
+        cellSize *= 1.5;
+    }
+    for( unsigned int a = 0; a < 3; ++a) {
+        mGridScale[a] = extent[a] > 0.f ? mGridSize[a] / extent[a] : 0.f;
+    }
+
+    // counting sort by cell, which keeps the positions of a cell in their order
+    const unsigned int numCells = mGridSize[0] * mGridSize[1] * mGridSize[2];
+    std::vector<unsigned int> cellOf( num);
+    mCellStart.assign( numCells + 1, 0);
+    for( unsigned int i = 0; i < num; ++i) {
+        const float* const pos = mPositions[i].mPosition;
+        unsigned int x, y, z, dummy;
+        GetCellRange( 0, pos[0], pos[0], x, dummy);
+        GetCellRange( 1, pos[1], pos[1], y, dummy);
+        GetCellRange( 2, pos[2], pos[2], z, dummy);
+        cellOf[i] = x + mGridSize[0] * (y + mGridSize[1] * z);
+        ++mCellStart[cellOf[i] + 1];
+    }
+    for( unsigned int c = 0; c < numCells; ++c) {
+        mCellStart[c + 1] += mCellStart[c];
+    }
+
+    std::vector<unsigned int> order( num);
+    std::vector<unsigned int> next( mCellStart.begin(), mCellStart.end() - 1);
+    for( unsigned int i = 0; i < num; ++i) {
+        order[next[cellOf[i]]++] = i;
+    }
+    Reorder( order);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialSort :: GetCellRange(unsigned int pAxis, float pLow, float pHigh,
+    unsigned int& poFirst, unsigned int& poLast) const
+{
+    // written so NaNs end up in the first cell
+    const float last = (float)(mGridSize[pAxis] - 1);
+    const float low = (pLow - mGridMin[pAxis]) * mGridScale[pAxis];
+    const float high = (pHigh - mGridMin[pAxis]) * mGridScale[pAxis];
+    poFirst = low > 0.f ? (unsigned int)std::min( low, last) : 0;
+    poLast = high > 0.f ? (unsigned int)std::min( high, last) : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialSort :: ScanRange(unsigned int pBegin, unsigned int pEnd, const aiVector3D& pPosition,
+    float pMinDist, float pMaxDist, float pSquared, std::vector<unsigned int>& poResults) const
+{
+    unsigned int i = pBegin;
+
+#ifdef AI_SPATIALSORT_SSE
+    // four at a time, in the same order of operations as aiVector3D::SquareLength()
+    const __m128 px = _mm_set1_ps( pPosition.x);
+    const __m128 py = _mm_set1_ps( pPosition.y);
+    const __m128 pz = _mm_set1_ps( pPosition.z);
+    const __m128 minDist = _mm_set1_ps( pMinDist);
+    const __m128 maxDist = _mm_set1_ps( pMaxDist);
+    const __m128 squared = _mm_set1_ps( pSquared);
+    for( ; i + 4 <= pEnd; i += 4) {
+        __m128 x = _mm_loadu_ps( mPositions[i].mPosition);
+        __m128 y = _mm_loadu_ps( mPositions[i + 1].mPosition);
+        __m128 z = _mm_loadu_ps( mPositions[i + 2].mPosition);
+        __m128 w = _mm_loadu_ps( mPositions[i + 3].mPosition);
+        _MM_TRANSPOSE4_PS( x, y, z, w);
+
+        const __m128 dx = _mm_sub_ps( x, px);
+        const __m128 dy = _mm_sub_ps( y, py);
+        const __m128 dz = _mm_sub_ps( z, pz);
+        const __m128 len = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx), _mm_mul_ps( dy, dy)), _mm_mul_ps( dz, dz));
+        const __m128 dist = _mm_loadu_ps( &mDistances[i]);
+
+        const int mask = _mm_movemask_ps( _mm_and_ps( _mm_cmplt_ps( len, squared),
+            _mm_and_ps( _mm_cmpge_ps( dist, minDist), _mm_cmplt_ps( dist, maxDist))));
+        if( !mask)
+            continue;
+        for( unsigned int k = 0; k < 4; ++k) {
+            if( mask & (1 << k))
+                poResults.push_back( mPositions[i + k].mIndex);
+        }
+    }
+#endif
+
+    for( ; i < pEnd; ++i) {
+        const float* const pos = mPositions[i].mPosition;
+        const aiVector3D diff( pos[0] - pPosition.x, pos[1] - pPosition.y, pos[2] - pPosition.z);
+        if( diff.SquareLength() < pSquared && mDistances[i] >= pMinDist && mDistances[i] < pMaxDist)
+            poResults.push_back( mPositions[i].mIndex);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Returns an iterator for all positions close to the given position.
 void SpatialSort::FindPositions( const aiVector3D& pPosition,
@@ -125,115 +410,46 @@ void SpatialSort::FindPositions( const aiVector3D& pPosition,
 {
     const float dist = pPosition * mPlaneNormal;
     const float minDist = dist - pRadius, maxDist = dist + pRadius;
+    const float pSquared = pRadius*pRadius;
 
     // clear the array in this strange fashion because a simple clear() would also deallocate
     // the array which we want to avoid
     poResults.erase( poResults.begin(), poResults.end());
 
-    // quick check for positions outside the range
     if( mPositions.size() == 0)
         return;
-    if( maxDist < mPositions.front().mDistance)
-        return;
-    if( minDist > mPositions.back().mDistance)
-        return;
 
-    // do a binary search for the minimal distance to start the iteration there
-    unsigned int index = (unsigned int)mPositions.size() / 2;
-    unsigned int binaryStepSize = (unsigned int)mPositions.size() / 4;
-    while( binaryStepSize > 1)
-    {
-        if( mPositions[index].mDistance < minDist)
-            index += binaryStepSize;
-        else
-            index -= binaryStepSize;
-
-        binaryStepSize /= 2;
+    if( mCellStart.empty()) {
+        // all positions within the radius lay in the range of distances, find its
+        // beginning by a binary search. It is usually short, just walk to its end.
+        const unsigned int begin = (unsigned int)(std::lower_bound( mDistances.begin(), mDistances.end(), minDist) - mDistances.begin());
+        unsigned int end = begin;
+        while( end < mDistances.size() && mDistances[end] < maxDist)
+            ++end;
+        ScanRange( begin, end, pPosition, minDist, maxDist, pSquared, poResults);
     }
-
-    // depending on the direction of the last step we need to single step a bit back or forth
-    // to find the actual beginning element of the range
-    while( index > 0 && mPositions[index].mDistance > minDist)
-        index--;
-    while( index < (mPositions.size() - 1) && mPositions[index].mDistance < minDist)
-        index++;
-
-    // Mow start iterating from there until the first position lays outside of the distance range.
-    // Add all positions inside the distance range within the given radius to the result aray
-    std::vector<Entry>::const_iterator it = mPositions.begin() + index;
-    const float pSquared = pRadius*pRadius;
-    while( it->mDistance < maxDist)
-    {
-        if( (it->mPosition - pPosition).SquareLength() < pSquared)
-            poResults.push_back( it->mIndex);
-        ++it;
-        if( it == mPositions.end())
-            break;
+    else {
+        // all cells touched by a box around the sphere, with some room for rounding.
+        // The cells of a row are adjacent in memory.
+        const float box = pRadius * 1.001f;
+        unsigned int x0, x1, y0, y1, z0, z1;
+        GetCellRange( 0, pPosition.x - box, pPosition.x + box, x0, x1);
+        GetCellRange( 1, pPosition.y - box, pPosition.y + box, y0, y1);
+        GetCellRange( 2, pPosition.z - box, pPosition.z + box, z0, z1);
+        for( unsigned int z = z0; z <= z1; ++z) {
+            for( unsigned int y = y0; y <= y1; ++y) {
+                const unsigned int row = mGridSize[0] * (y + mGridSize[1] * z);
+                ScanRange( mCellStart[row + x0], mCellStart[row + x1 + 1],
+                    pPosition, minDist, maxDist, pSquared, poResults);
+            }
+        }
     }
 
-    // that's it
+    // the order must not depend on how the positions are stored
+    if( poResults.size() > 1)
+        std::sort( poResults.begin(), poResults.end());
 }
 
-namespace {
-
-    // Binary, signed-integer representation of a single-precision floating-point value.
-    // IEEE 754 says: "If two floating-point numbers in the same format are ordered then they are
-    //  ordered the same way when their bits are reinterpreted as sign-magnitude integers."
-    // This allows us to convert all floating-point numbers to signed integers of arbitrary size
-    //  and then use them to work with ULPs (Units in the Last Place, for high-precision
-    //  computations) or to compare them (integer comparisons are faster than floating-point
-    //  comparisons on many platforms).
-    typedef signed int BinFloat;
-
-    // --------------------------------------------------------------------------------------------
-    // Converts the bit pattern of a floating-point number to its signed integer representation.
-    BinFloat ToBinary( const float & pValue) {
-
-        // If this assertion fails, signed int is not big enough to store a float on your platform.
-        //  Please correct the declaration of BinFloat a few lines above - but do it in a portable,
-        //  #ifdef'd manner!
-        BOOST_STATIC_ASSERT( sizeof(BinFloat) >= sizeof(float));
-
-        #if defined( _MSC_VER)
-            // If this assertion fails, Visual C++ has finally moved to ILP64. This means that this
-            //  code has just become legacy code! Find out the current value of _MSC_VER and modify
-            //  the #if above so it evaluates false on the current and all upcoming VC versions (or
-            //  on the current platform, if LP64 or LLP64 are still used on other platforms).
-            BOOST_STATIC_ASSERT( sizeof(BinFloat) == sizeof(float));
-
-            // This works best on Visual C++, but other compilers have their problems with it.
-            const BinFloat binValue = reinterpret_cast<BinFloat const &>(pValue);
-        #else
-            // On many compilers, reinterpreting a float address as an integer causes aliasing
-            // problems. This is an ugly but more or less safe way of doing it.
-            union {
-                float       asFloat;
-                BinFloat    asBin;
-            } conversion;
-            conversion.asBin    = 0; // zero empty space in case sizeof(BinFloat) > sizeof(float)
-            conversion.asFloat  = pValue;
-            const BinFloat binValue = conversion.asBin;
-        #endif
-
-        // floating-point numbers are of sign-magnitude format, so find out what signed number
-        //  representation we must convert negative values to.
-        // See http://en.wikipedia.org/wiki/Signed_number_representations.
-
-        // Two's complement?
-        if( (-42 == (~42 + 1)) && (binValue & 0x80000000))
-            return BinFloat(1 << (CHAR_BIT * sizeof(BinFloat) - 1)) - binValue;
-        // One's complement?
-        else if( (-42 == ~42) && (binValue & 0x80000000))
-            return BinFloat(-0) - binValue;
-        // Sign-magnitude?
-        else if( (-42 == (42 | (-0))) && (binValue & 0x80000000)) // -0 = 1000... binary
-            return binValue;
-        else
-            return binValue;
-    }
-
-} // namespace
-
 // ------------------------------------------------------------------------------------------------
 // Fills an array with indices of all positions indentical to the given position. In opposite to
 // FindPositions(), not an epsilon is used but a (very low) tolerance of four floating-point units.
@@ -272,72 +488,111 @@ void SpatialSort::FindIdenticalPositions( const aiVector3D& pPosition,
     // the array which we want to avoid
     poResults.erase( poResults.begin(), poResults.end());
 
-    // do a binary search for the minimal distance to start the iteration there
-    unsigned int index = (unsigned int)mPositions.size() / 2;
-    unsigned int binaryStepSize = (unsigned int)mPositions.size() / 4;
-    while( binaryStepSize > 1)
-    {
-        // Ugly, but conditional jumps are faster with integers than with floats
-        if( minDistBinary > ToBinary(mPositions[index].mDistance))
-            index += binaryStepSize;
-        else
-            index -= binaryStepSize;
-
-        binaryStepSize /= 2;
+    // the entries to look at: those from the minimal distance on, or those in the
+    // cells around the position. Identical positions are much closer than the box.
+    unsigned int begin = 0, end = (unsigned int)mPositions.size();
+    unsigned int x0 = 0, x1 = 0, y0 = 0, y1 = 0, z0 = 0, z1 = 0;
+    if( mCellStart.empty()) {
+        // do a binary search for the minimal distance to start the iteration there
+        while( begin < end) {
+            // Ugly, but conditional jumps are faster with integers than with floats
+            const unsigned int mid = begin + (end - begin) / 2;
+            if( minDistBinary > ToBinary(mDistances[mid]))
+                begin = mid + 1;
+            else
+                end = mid;
+        }
+        end = (unsigned int)mPositions.size();
+    }
+    else {
+        const float box = 1e-20f;
+        GetCellRange( 0, pPosition.x - box, pPosition.x + box, x0, x1);
+        GetCellRange( 1, pPosition.y - box, pPosition.y + box, y0, y1);
+        GetCellRange( 2, pPosition.z - box, pPosition.z + box, z0, z1);
     }
 
-    // depending on the direction of the last step we need to single step a bit back or forth
-    // to find the actual beginning element of the range
-    while( index > 0 && minDistBinary < ToBinary(mPositions[index].mDistance) )
-        index--;
-    while( index < (mPositions.size() - 1) && minDistBinary > ToBinary(mPositions[index].mDistance))
-        index++;
-
-    // Now start iterating from there until the first position lays outside of the distance range.
-    // Add all positions inside the distance range within the tolerance to the result aray
-    std::vector<Entry>::const_iterator it = mPositions.begin() + index;
-    while( ToBinary(it->mDistance) < maxDistBinary)
-    {
-        if( distance3DToleranceInULPs >= ToBinary((it->mPosition - pPosition).SquareLength()))
-            poResults.push_back(it->mIndex);
-        ++it;
-        if( it == mPositions.end())
-            break;
+    for( unsigned int z = z0; z <= z1; ++z) {
+        for( unsigned int y = y0; y <= y1; ++y) {
+            if( !mCellStart.empty()) {
+                const unsigned int row = mGridSize[0] * (y + mGridSize[1] * z);
+                begin = mCellStart[row + x0];
+                end = mCellStart[row + x1 + 1];
+            }
+
+            // Add all positions inside the distance range within the tolerance to the result aray
+            for( unsigned int i = begin; i < end; ++i) {
+                const BinFloat distBinary = ToBinary( mDistances[i]);
+                if( distBinary >= maxDistBinary) {
+                    // nothing more to find in the sorted array
+                    if( mCellStart.empty())
+                        break;
+                    continue;
+                }
+                if( distBinary < minDistBinary)
+                    continue;
+
+                const float* const pos = mPositions[i].mPosition;
+                const aiVector3D diff( pos[0] - pPosition.x, pos[1] - pPosition.y, pos[2] - pPosition.z);
+                if( distance3DToleranceInULPs >= ToBinary(diff.SquareLength()))
+                    poResults.push_back( mPositions[i].mIndex);
+            }
+        }
     }
 
-    // that's it
+    // the order must not depend on how the positions are stored
+    if( poResults.size() > 1)
+        std::sort( poResults.begin(), poResults.end());
 }
 
 // ------------------------------------------------------------------------------------------------
 unsigned int SpatialSort::GenerateMappingTable(std::vector<unsigned int>& fill,float pRadius) const
 {
-    fill.resize(mPositions.size(),UINT_MAX);
-    float dist, maxDist;
+    const size_t num = mPositions.size();
+    fill.resize(num,UINT_MAX);
+
+    // walk the positions by their distance to the plane, the grid needs to sort
+    // them for that first. Equal distances come by ascending index either way.
+    std::vector<unsigned int> order;
+    if (!mCellStart.empty()) {
+        std::vector<float> distances(num);
+        std::vector<unsigned int> slots(num);
+        for (size_t i = 0; i < num; ++i) {
+            distances[mPositions[i].mIndex] = mDistances[i];
+            slots[mPositions[i].mIndex] = (unsigned int)i;
+        }
+        RadixSort(distances, order);
+        for (size_t i = 0; i < num; ++i) {
+            order[i] = slots[order[i]];
+        }
+    }
 
     unsigned int t=0;
     const float pSquared = pRadius*pRadius;
-    for (size_t i = 0; i < mPositions.size();) {
-        dist = mPositions[i].mPosition * mPlaneNormal;
-        maxDist = dist + pRadius;
+    for (size_t k = 0; k < num;) {
+        const size_t i = order.empty() ? k : order[k];
+        const float maxDist = mDistances[i] + pRadius;
 
         fill[mPositions[i].mIndex] = t;
-        const aiVector3D& oldpos = mPositions[i].mPosition;
-        for (++i; i < fill.size() && mPositions[i].mDistance < maxDist
-            && (mPositions[i].mPosition - oldpos).SquareLength() < pSquared; ++i)
-        {
-            fill[mPositions[i].mIndex] = t;
+        const float* const oldpos = mPositions[i].mPosition;
+        for (++k; k < num; ++k) {
+            const size_t j = order.empty() ? k : order[k];
+            const float* const pos = mPositions[j].mPosition;
+            const aiVector3D diff(pos[0] - oldpos[0], pos[1] - oldpos[1], pos[2] - oldpos[2]);
+            if (mDistances[j] >= maxDist || diff.SquareLength() >= pSquared) {
+                break;
+            }
+            fill[mPositions[j].mIndex] = t;
         }
         ++t;
     }
 
 #ifdef ASSIMP_BUILD_DEBUG
 
-    // debug invariant: mPositions[i].mIndex values must range from 0 to mPositions.size()-1
+    // debug invariant: mIndex values must range from 0 to mPositions.size()-1
     for (size_t i = 0; i < fill.size(); ++i) {
-        ai_assert(fill[i]<mPositions.size());
+        ai_assert(fill[i]<num);
     }
 
 #endif
     return t;
 }
-
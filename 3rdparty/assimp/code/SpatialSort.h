@@ -45,6 +45,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include "../include/assimp/types.h"
 
+/** Number of positions from which on a SpatialSort is backed by a uniform grid
+ *  instead of an array sorted along the reference plane. Both return the same
+ *  results, the grid is cheaper to build and to query for large meshes.
+ *  Define to 0 to always use the sorted array. */
+#ifndef AI_SPATIALSORT_GRID_THRESHOLD
+#   define AI_SPATIALSORT_GRID_THRESHOLD 4096
+#endif
+
 namespace Assimp
 {
 
@@ -54,7 +62,11 @@ namespace Assimp
  * by their indices and sorts them by their distance to an arbitrary chosen plane.
  * You can then query the instance for all vertices close to a given position in an average O(log n)
  * time, with O(n) worst case complexity when all vertices lay on the plane. The plane is chosen
- * so that it avoids common planes in usual data sets. */
+ * so that it avoids common planes in usual data sets.
+ *
+ * Large sets of positions are bucketed into a uniform grid instead, see
+ * #AI_SPATIALSORT_GRID_THRESHOLD. Queries return the indices found in ascending order
+ * either way. */
 // ------------------------------------------------------------------------------------------------
 class SpatialSort
 {
@@ -141,28 +153,47 @@ public:
     unsigned int GenerateMappingTable(std::vector<unsigned int>& fill,
         float pRadius) const;
 
+protected:
+
+    /** Reorder positions and distances by the given permutation */
+    void Reorder(const std::vector<unsigned int>& order);
+
+    /** Bucket the positions into a uniform grid of about two positions per cell */
+    void BuildGrid();
+
+    /** Get the range of grid cells covering [pLow,pHigh] along one axis */
+    void GetCellRange(unsigned int pAxis, float pLow, float pHigh,
+        unsigned int& poFirst, unsigned int& poLast) const;
+
+    /** Add the positions in [pBegin,pEnd) within the distance range [pMinDist,pMaxDist)
+     *  and closer than sqrt(pSquared) to pPosition to the results */
+    void ScanRange(unsigned int pBegin, unsigned int pEnd, const aiVector3D& pPosition,
+        float pMinDist, float pMaxDist, float pSquared, std::vector<unsigned int>& poResults) const;
+
 protected:
     /** Normal of the sorting plane, normalized. The center is always at (0, 0, 0) */
     aiVector3D mPlaneNormal;
 
-    /** An entry in a spatially sorted position array. Consists of a vertex index,
-     * its position and its precalculated distance from the reference plane */
+    /** A position along with its vertex index, 16 bytes so four of them
+     *  load as a 4x4 block */
     struct Entry
     {
-        unsigned int mIndex; ///< The vertex referred by this entry
-        aiVector3D mPosition; ///< Position
-        float mDistance; ///< Distance of this vertex to the sorting plane
-
-        Entry() { /** intentionally not initialized.*/ }
-        Entry( unsigned int pIndex, const aiVector3D& pPosition, float pDistance)
-            : mIndex( pIndex), mPosition( pPosition), mDistance( pDistance)
-        {   }
-
-        bool operator < (const Entry& e) const { return mDistance < e.mDistance; }
+        float mPosition[3];
+        unsigned int mIndex;
     };
 
-    // all positions, sorted by distance to the sorting plane
+    // all positions and their distances to the reference plane, kept apart as the
+    // searches only need the distances. Sorted by distance to the sorting plane,
+    // or by grid cell.
     std::vector<Entry> mPositions;
+    std::vector<float> mDistances;
+
+    // the grid, if in use: first entry of every cell plus one past the end,
+    // cells are ordered x first, then y, then z.
+    std::vector<unsigned int> mCellStart;
+    unsigned int mGridSize[3];
+    float mGridMin[3];
+    float mGridScale[3];
 };
 
 } // end of namespace Assimp
@@ -103,10 +103,15 @@ void TriangulateProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("TriangulateProcess begin");
 
+    std::vector<unsigned char> abHas(pScene->mNumMeshes);
+    ParallelForMeshes(pScene, [&](unsigned int a) {
+        abHas[a] = TriangulateMesh( pScene->mMeshes[a]);
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
     {
-        if( TriangulateMesh( pScene->mMeshes[a]))
+        if( abHas[a])
             bHas = true;
     }
     if (bHas)DefaultLogger::get()->info ("TriangulateProcess finished. All polygons have been triangulated.");
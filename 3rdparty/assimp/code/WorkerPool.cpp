@@ -0,0 +1,180 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  WorkerPool.cpp
+ *  @brief Implementation of the WorkerPool helper class
+ */
+
+#include "WorkerPool.h"
+#include <algorithm>
+
+using namespace Assimp;
+
+namespace {
+
+// set while a thread runs jobs of a loop
+thread_local bool runningJob = false;
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+WorkerPool::WorkerPool(unsigned int numThreads)
+: mJob()
+, mCount()
+, mGeneration()
+, mBusy()
+, mShutdown()
+, mNext()
+{
+    if (!numThreads) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // the calling thread is the first worker
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        mThreads.push_back(std::thread(&WorkerPool::WorkerMain, this));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShutdown = true;
+    }
+    mWake.notify_all();
+
+    for (std::vector<std::thread>::iterator it = mThreads.begin(); it != mThreads.end(); ++it) {
+        (*it).join();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void WorkerPool::ParallelFor(unsigned int count, const std::function<void (unsigned int)>& job)
+{
+    if (!count) {
+        return;
+    }
+
+    // nothing to share, skip the synchronization. The threads are
+    // busy with the outer loop if this is called from a job.
+    if (mThreads.empty() || count == 1 || runningJob) {
+        for (unsigned int i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = &job;
+        mCount = count;
+        mNext = 0;
+        mError = std::exception_ptr();
+        mBusy = static_cast<unsigned int>(mThreads.size());
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    RunJob();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mBusy == 0; });
+    mJob = NULL;
+
+    if (mError) {
+        std::exception_ptr e = mError;
+        mError = std::exception_ptr();
+        std::rethrow_exception(e);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool WorkerPool::IsRunningJob()
+{
+    return runningJob;
+}
+
+// ------------------------------------------------------------------------------------------------
+void WorkerPool::RunJob()
+{
+    runningJob = true;
+    for (unsigned int i = mNext++; i < mCount; i = mNext++) {
+        try {
+            (*mJob)(i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mError) {
+                mError = std::current_exception();
+            }
+
+            // skip the remaining items
+            mNext = mCount;
+        }
+    }
+    runningJob = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void WorkerPool::WorkerMain()
+{
+    unsigned int seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this, seen] { return mShutdown || mGeneration != seen; });
+            if (mShutdown) {
+                return;
+            }
+            seen = mGeneration;
+        }
+
+        RunJob();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mBusy;
+        }
+        mDone.notify_one();
+    }
+}
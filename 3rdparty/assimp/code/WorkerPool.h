@@ -0,0 +1,128 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  WorkerPool.h
+ *  @brief A fixed set of threads to run loops over independent items
+ */
+#ifndef AI_WORKERPOOL_H_INC
+#define AI_WORKERPOOL_H_INC
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** A fixed set of worker threads to run loops over independent items.
+ *
+ *  Items are handed out one at a time from a shared counter, so threads
+ *  which finish early pick up the remaining work. The calling thread
+ *  takes part in the loop as well, a pool of size 1 therefore doesn't
+ *  spawn any threads and runs everything inline.
+ *
+ *  A pool runs one loop at a time. A loop started from within a job, i.e.
+ *  a per vertex loop inside a per mesh loop, runs inline on the thread
+ *  of that job.
+ */
+class WorkerPool
+{
+public:
+
+    // -------------------------------------------------------------------
+    /** @param numThreads Total number of threads to use, including the
+     *    calling thread. 0 picks the number of hardware threads.
+     */
+    explicit WorkerPool(unsigned int numThreads);
+    ~WorkerPool();
+
+public:
+
+    unsigned int GetNumThreads() const {
+        return static_cast<unsigned int>(mThreads.size()) + 1;
+    }
+
+    // -------------------------------------------------------------------
+    /** Check whether the calling thread is running a job of any pool,
+     *  so a new loop would run inline.
+     */
+    static bool IsRunningJob();
+
+    // -------------------------------------------------------------------
+    /** Call job(i) for all i in [0,count) and wait until all calls have
+     *  returned. If any of the calls throws, the first exception is
+     *  rethrown on the calling thread after all threads have finished.
+     */
+    void ParallelFor(unsigned int count, const std::function<void (unsigned int)>& job);
+
+private:
+
+    void WorkerMain();
+    void RunJob();
+
+    // Prohibit copy constructor & assignment operator.
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+
+private:
+
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mWake, mDone;
+
+    // current loop, guarded by mMutex
+    const std::function<void (unsigned int)>* mJob;
+    unsigned int mCount;
+    unsigned int mGeneration;
+    unsigned int mBusy;
+    bool mShutdown;
+    std::exception_ptr mError;
+
+    std::atomic<unsigned int> mNext;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_WORKERPOOL_H_INC
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Public ASSIMP data structures
 #include "types.h"
 #include "config.h"
+#include "Profiling.hpp"
 
 namespace Assimp    {
     // =======================================================================
@@ -607,6 +608,16 @@ public:
      *   is (naturally) not included.*/
     void GetMemoryRequirements(aiMemoryInfo& in) const;
 
+    // -------------------------------------------------------------------
+    /** Returns the measurements taken by the last call to #ReadFile() and
+     * any following calls to #ApplyPostProcessing().
+     *
+     * Measurements are only taken if #AI_CONFIG_GLOB_MEASURE_TIME is set.
+     * There is one entry for the importer, one for the scene preprocessor,
+     * one for each post processing step executed and one for the whole
+     * #ReadFile() call, in the order they finished. */
+    const ProfileRegionList& GetProfile() const;
+
     // -------------------------------------------------------------------
     /** Enables "extra verbose" mode.
      *
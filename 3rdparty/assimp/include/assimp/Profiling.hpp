@@ -0,0 +1,94 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2015, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file Profiling.hpp
+ *  @brief Measurements taken by #Importer::ReadFile() with AI_CONFIG_GLOB_MEASURE_TIME.
+ */
+#ifndef INCLUDED_AI_PROFILING_H
+#define INCLUDED_AI_PROFILING_H
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace Assimp    {
+
+// ------------------------------------------------------------------------------------
+/** @brief CPP-API: Measurements for one region of work, i.e. the importer, a single
+ *  post processing step or a section of an exporter.
+ *
+ *  Times and memory are taken for the whole process, so they include other
+ *  threads working at the same time. */
+struct ProfileRegion
+{
+    ProfileRegion()
+        : mWallTime()
+        , mCpuTime()
+        , mPeakMemoryDelta()
+        , mVerticesIn()
+        , mFacesIn()
+        , mVerticesOut()
+        , mFacesOut()
+    {}
+
+    /** Name of the region, e.g. "import:Collada Importer" or
+     *  "postprocess:JoinIdenticalVertices" */
+    std::string mName;
+
+    /** Elapsed real time, in seconds */
+    double mWallTime;
+
+    /** Processor time used by the process, in seconds */
+    double mCpuTime;
+
+    /** Number of bytes the peak resident set size of the process grew by */
+    size_t mPeakMemoryDelta;
+
+    /** Total number of vertices and faces of all meshes before and
+     *  after the region */
+    unsigned int mVerticesIn, mFacesIn;
+    unsigned int mVerticesOut, mFacesOut;
+};
+
+typedef std::vector<ProfileRegion> ProfileRegionList;
+
+} // Namespace Assimp
+
+#endif // INCLUDED_AI_PROFILING_H
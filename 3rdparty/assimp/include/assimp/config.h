@@ -70,7 +70,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  If enabled, measures the time needed for each part of the loading
  *  process (i.e. IO time, importing, postprocessing, ..) and dumps
  *  these timings to the DefaultLogger. See the @link perf Performance
- *  Page@endlink for more information on this topic.
+ *  Page@endlink for more information on this topic. The full
+ *  measurements are available from Importer::GetProfile().
  *
  * Property type: bool. Default value: false.
  */
@@ -78,6 +79,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     "GLOB_MEASURE_TIME"
 
 
+// ---------------------------------------------------------------------------
+/** @brief Number of threads post processing may use.
+ *
+ *  Steps which work on each mesh on its own, such as normal and tangent
+ *  generation, JoinIdenticalVertices, triangulation or cache locality
+ *  optimization, process several meshes at once. The results are the same
+ *  for any number of threads. 0 uses one thread per hardware thread.
+ *
+ * Property type: integer. Default value: 1.
+ */
+#define AI_CONFIG_GLOB_NUM_THREADS  \
+    "GLOB_NUM_THREADS"
+
+
 // ---------------------------------------------------------------------------
 /** @brief Global setting to disable generation of skeleton dummy meshes
  *
@@ -265,6 +280,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_FD_REMOVE \
     "PP_FD_REMOVE"
 
+// ---------------------------------------------------------------------------
+/** @brief Configures the #aiProcess_JoinIdenticalVertices step to join
+ *  only vertices whose attributes are bit-identical.
+ *
+ * Vertices are then looked up in a hash table of the attributes the mesh
+ * actually has, in a single pass over the vertices. This is a lot faster
+ * than the default, which also joins vertices whose attributes differ by
+ * less than a small epsilon, but leaves vertices apart which differ by a
+ * rounding error only.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_JV_EXACT \
+    "PP_JV_EXACT"
+
 // ---------------------------------------------------------------------------
 /** @brief Configures the #aiProcess_OptimizeGraph step to preserve nodes
  * matching a name in a given list.
@@ -355,6 +384,58 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_DB_ALL_OR_NONE \
     "PP_DB_ALL_OR_NONE"
 
+// ---------------------------------------------------------------------------
+/** @brief Fraction of the triangles of each mesh to keep.
+ *
+ * This is used by the #aiProcess_SimplifyMeshes PostProcess-Step.
+ * @note The default value is 0.5
+ * Property type: float.*/
+#define AI_CONFIG_PP_SM_TARGET_RATIO \
+    "PP_SM_TARGET_RATIO"
+
+// ---------------------------------------------------------------------------
+/** @brief Largest error a mesh may be simplified to, relative to the
+ *  size of the mesh.
+ *
+ * Simplification of a mesh stops before the target ratio is reached if
+ * the next collapse would cause a larger error. The error is measured as
+ * a distance, given as a fraction of the diagonal of the mesh's bounds.
+ * This is used by the #aiProcess_SimplifyMeshes PostProcess-Step.
+ * @note The default value is 0.01
+ * Property type: float.*/
+#define AI_CONFIG_PP_SM_MAX_ERROR \
+    "PP_SM_MAX_ERROR"
+
+// ---------------------------------------------------------------------------
+/** @brief Maximum number of vertices referenced by a cluster.
+ *
+ * This is used by the #aiProcess_GenMeshlets PostProcess-Step.
+ * @note The default value is AI_GM_DEFAULT_MAX_VERTICES
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_VERTICES \
+    "PP_GM_MAX_VERTICES"
+
+// default value for AI_CONFIG_PP_GM_MAX_VERTICES
+#if (!defined AI_GM_DEFAULT_MAX_VERTICES)
+#   define AI_GM_DEFAULT_MAX_VERTICES       64
+#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Maximum number of triangles in a cluster.
+ *
+ * This is used by the #aiProcess_GenMeshlets PostProcess-Step.
+ * @note The default value is AI_GM_DEFAULT_MAX_TRIANGLES
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_TRIANGLES \
+    "PP_GM_MAX_TRIANGLES"
+
+// default value for AI_CONFIG_PP_GM_MAX_TRIANGLES
+#if (!defined AI_GM_DEFAULT_MAX_TRIANGLES)
+#   define AI_GM_DEFAULT_MAX_TRIANGLES      124
+#endif
+
 /** @brief Default value for the #AI_CONFIG_PP_ICL_PTCACHE_SIZE property
  */
 #ifndef PP_ICL_PTCACHE_SIZE
@@ -523,7 +523,45 @@ enum aiPostProcessSteps
      *  Use <tt>#AI_CONFIG_PP_DB_ALL_OR_NONE</tt> if you want bones removed if and
      *  only if all bones within the scene qualify for removal.
     */
-    aiProcess_Debone  = 0x4000000
+    aiProcess_Debone  = 0x4000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>This step reduces the number of triangles of each mesh.
+     *
+     *  Edges are collapsed in order of the error they introduce, measured
+     *  with quadric error metrics on the positions plus the change of the
+     *  normals and texture coordinates. Vertices keep their positions and
+     *  attributes, so no vertex data is interpolated. Borders of open
+     *  meshes are only collapsed along themselves, pairs of vertices on
+     *  normal or texture seams only together along the seam, and where
+     *  more than two vertices share a position they are kept.
+     *
+     *  Use <tt>#AI_CONFIG_PP_SM_TARGET_RATIO</tt> and
+     *  <tt>#AI_CONFIG_PP_SM_MAX_ERROR</tt> to control this. Meshes which
+     *  aren't made of triangles only are left alone, so this step is best
+     *  used with #aiProcess_Triangulate and #aiProcess_SortByPType. It
+     *  requires #aiProcess_JoinIdenticalVertices.
+    */
+    aiProcess_SimplifyMeshes = 0x8000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>This step reorders the triangles of each mesh into clusters.
+     *
+     *  Each cluster (meshlet) is a run of consecutive triangles referencing
+     *  at most <tt>#AI_CONFIG_PP_GM_MAX_VERTICES</tt> vertices and holding
+     *  at most <tt>#AI_CONFIG_PP_GM_MAX_TRIANGLES</tt> triangles, grown
+     *  over adjacent triangles so that it covers a compact piece of the
+     *  surface. A new cluster starts exactly where the next triangle
+     *  would exceed either limit, so the clusters are found again by a
+     *  single pass over the faces with the same limits; see
+     *  Assimp::GenMeshletsProcess::GetMeshlets(), which also computes the
+     *  bounding sphere and normal cone of each cluster for culling.
+     *
+     *  Meshes which aren't made of triangles only are left alone. Run
+     *  after #aiProcess_ImproveCacheLocality, whose order is kept for
+     *  picking the first triangle of each cluster.
+    */
+    aiProcess_GenMeshlets = 0x10000000
 
     // aiProcess_GenEntityMeshes = 0x100000,
     // aiProcess_OptimizeAnimations = 0x200000
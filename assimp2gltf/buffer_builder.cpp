@@ -0,0 +1,674 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "buffer_builder.h"
+#include "scene_bounds.h"
+#include "stream_codec.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/scene.h>
+#include <assimp/../../code/WorkerPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// all bufferViews start at a multiple of this, so FLOAT data following
+// an odd number of UNSIGNED_SHORT indices is still properly aligned.
+const size_t kViewAlignment = 4;
+
+// number of elements converted at once for streams that can't be written
+// straight from the source mesh (16 bit indices, 2-component UVs, quantized streams).
+const unsigned int kConversionBatch = 4096;
+
+// ------------------------------------------------------------------------------------------------
+unsigned int GetIndicesPerFace(const aiMesh& mesh)
+{
+	switch (mesh.mPrimitiveTypes)
+	{
+	case aiPrimitiveType_POINT:
+		return 1;
+	case aiPrimitiveType_LINE:
+		return 2;
+	case aiPrimitiveType_TRIANGLE:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int GetNumUVComponents(const aiMesh& mesh, unsigned int channel)
+{
+	return mesh.mNumUVComponents[channel] ? mesh.mNumUVComponents[channel] : 2;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+void WriteIndices(Assimp::IOStream& out, const aiMesh& mesh)
+{
+	T batch[kConversionBatch];
+	unsigned int cursor = 0;
+
+	for (unsigned int i = 0; i < mesh.mNumFaces; ++i) {
+		const aiFace& face = mesh.mFaces[i];
+		for (unsigned int n = 0; n < face.mNumIndices; ++n) {
+			batch[cursor++] = static_cast<T>(face.mIndices[n]);
+			if (cursor == kConversionBatch) {
+				out.Write(batch, sizeof(T), cursor);
+				cursor = 0;
+			}
+		}
+	}
+	if (cursor) {
+		out.Write(batch, sizeof(T), cursor);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void WriteTextureCoords(Assimp::IOStream& out, const aiVector3D* uv, unsigned int count, unsigned int numc)
+{
+	float batch[kConversionBatch];
+	const unsigned int per_batch = kConversionBatch / numc;
+
+	for (unsigned int base = 0; base < count; base += per_batch) {
+		const unsigned int end = std::min(count, base + per_batch);
+
+		float* cursor = batch;
+		for (unsigned int i = base; i < end; ++i) {
+			for (unsigned int c = 0; c < numc; ++c) {
+				*cursor++ = uv[i][c];
+			}
+		}
+		out.Write(batch, sizeof(float), static_cast<size_t>(cursor - batch));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void ComputeBounds(const aiVector3D* v, unsigned int count, unsigned int numc, float* min, float* max)
+{
+	if (numc == 3) {
+		aiVector3D box_min, box_max;
+		ComputeBox(v, count, box_min, box_max);
+		for (unsigned int c = 0; c < 3; ++c) {
+			min[c] = box_min[c];
+			max[c] = box_max[c];
+		}
+		return;
+	}
+
+	for (unsigned int c = 0; c < numc; ++c) {
+		min[c] =  std::numeric_limits<float>::max();
+		max[c] = -std::numeric_limits<float>::max();
+	}
+	for (unsigned int i = 0; i < count; ++i) {
+		for (unsigned int c = 0; c < numc; ++c) {
+			min[c] = std::min(min[c], v[i][c]);
+			max[c] = std::max(max[c], v[i][c]);
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Map each component linearly from [min,max] to [0,65535]
+void WriteLinear16(Assimp::IOStream& out, const aiVector3D* v, unsigned int count, unsigned int numc,
+	const float* min, const float* max)
+{
+	float scale[3];
+	for (unsigned int c = 0; c < numc; ++c) {
+		scale[c] = max[c] > min[c] ? 65535.f / (max[c] - min[c]) : 0.f;
+	}
+
+	unsigned short batch[kConversionBatch];
+	const unsigned int per_batch = kConversionBatch / numc;
+
+	for (unsigned int base = 0; base < count; base += per_batch) {
+		const unsigned int end = std::min(count, base + per_batch);
+
+		unsigned short* cursor = batch;
+		for (unsigned int i = base; i < end; ++i) {
+			for (unsigned int c = 0; c < numc; ++c) {
+				const float q = (v[i][c] - min[c]) * scale[c] + 0.5f;
+				*cursor++ = static_cast<unsigned short>(std::min(q, 65535.f));
+			}
+		}
+		out.Write(batch, sizeof(unsigned short), static_cast<size_t>(cursor - batch));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Map a direction onto the octahedron |x|+|y|+|z| = 1 and unfold the lower half onto the
+// corners of the [-1,1] square.
+void OctahedralProject(const aiVector3D& v, float& x, float& y)
+{
+	const float l1 = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+	if (l1 == 0.f) {
+		x = y = 0.f;
+		return;
+	}
+
+	x = v.x / l1;
+	y = v.y / l1;
+	if (v.z < 0.f) {
+		const float ox = x;
+		x = (1.f - std::fabs(y)) * (ox >= 0.f ? 1.f : -1.f);
+		y = (1.f - std::fabs(ox)) * (y >= 0.f ? 1.f : -1.f);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+aiVector3D OctahedralUnproject(float x, float y)
+{
+	aiVector3D v(x, y, 1.f - std::fabs(x) - std::fabs(y));
+	if (v.z < 0.f) {
+		const float ox = v.x;
+		v.x = (1.f - std::fabs(v.y)) * (ox >= 0.f ? 1.f : -1.f);
+		v.y = (1.f - std::fabs(ox)) * (v.y >= 0.f ? 1.f : -1.f);
+	}
+	return v.Normalize();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Octahedral encoding to two normalized bytes. Of the four grid points around the projected
+// direction, the one decoding closest to it is taken rather than just rounding each coordinate.
+void WriteOctahedral8(Assimp::IOStream& out, const aiVector3D* v, unsigned int count)
+{
+	signed char batch[kConversionBatch];
+	const unsigned int per_batch = kConversionBatch / 2;
+
+	for (unsigned int base = 0; base < count; base += per_batch) {
+		const unsigned int end = std::min(count, base + per_batch);
+
+		signed char* cursor = batch;
+		for (unsigned int i = base; i < end; ++i) {
+			float x, y;
+			OctahedralProject(v[i], x, y);
+
+			const aiVector3D dir = aiVector3D(v[i]).Normalize();
+			const float fx = std::floor(x * 127.f), fy = std::floor(y * 127.f);
+
+			float best_x = fx, best_y = fy, best_dot = -2.f;
+			for (unsigned int n = 0; n < 4; ++n) {
+				const float qx = std::max(-127.f, std::min(127.f, fx + (n & 1)));
+				const float qy = std::max(-127.f, std::min(127.f, fy + (n >> 1)));
+
+				const float dot = OctahedralUnproject(qx / 127.f, qy / 127.f) * dir;
+				if (dot > best_dot) {
+					best_dot = dot;
+					best_x = qx;
+					best_y = qy;
+				}
+			}
+
+			*cursor++ = static_cast<signed char>(best_x);
+			*cursor++ = static_cast<signed char>(best_y);
+		}
+		out.Write(batch, sizeof(signed char), static_cast<size_t>(cursor - batch));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void WriteSnorm16(Assimp::IOStream& out, const aiVector3D* v, unsigned int count)
+{
+	short batch[kConversionBatch];
+	const unsigned int per_batch = kConversionBatch / 3;
+
+	for (unsigned int base = 0; base < count; base += per_batch) {
+		const unsigned int end = std::min(count, base + per_batch);
+
+		short* cursor = batch;
+		for (unsigned int i = base; i < end; ++i) {
+			for (unsigned int c = 0; c < 3; ++c) {
+				const float f = std::max(-1.f, std::min(1.f, v[i][c]));
+				*cursor++ = static_cast<short>(std::floor(f * 32767.f + 0.5f));
+			}
+		}
+		out.Write(batch, sizeof(short), static_cast<size_t>(cursor - batch));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+const aiVector3D* GetVectors(const aiMesh& mesh, BufferBuilder::Source source, unsigned int channel)
+{
+	switch (source)
+	{
+	case BufferBuilder::Source_Positions:
+		return mesh.mVertices;
+	case BufferBuilder::Source_Normals:
+		return mesh.mNormals;
+	case BufferBuilder::Source_Tangents:
+		return mesh.mTangents;
+	case BufferBuilder::Source_Bitangents:
+		return mesh.mBitangents;
+	case BufferBuilder::Source_TextureCoords:
+		return mesh.mTextureCoords[channel];
+	default:
+		return NULL;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int GetComponentSize(WebGL::GLenum type)
+{
+	switch (type)
+	{
+	case WebGL::BYTE:
+	case WebGL::UNSIGNED_BYTE:
+		return 1;
+	case WebGL::SHORT:
+	case WebGL::UNSIGNED_SHORT:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Write-only IOStream collecting its output in memory
+class VectorIOStream : public Assimp::IOStream
+{
+public:
+
+	explicit VectorIOStream(std::vector<unsigned char>& data)
+		: data(data)
+	{
+	}
+
+	size_t Read(void*, size_t, size_t) {
+		return 0;
+	}
+
+	size_t Write(const void* pvBuffer, size_t pSize, size_t pCount) {
+		const unsigned char* const p = static_cast<const unsigned char*>(pvBuffer);
+		data.insert(data.end(), p, p + pSize * pCount);
+		return pCount;
+	}
+
+	aiReturn Seek(size_t, aiOrigin) {
+		return AI_FAILURE;
+	}
+
+	size_t Tell() const {
+		return data.size();
+	}
+
+	size_t FileSize() const {
+		return data.size();
+	}
+
+	void Flush() {
+	}
+
+private:
+
+	std::vector<unsigned char>& data;
+};
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+BufferBuilder :: BufferBuilder()
+: byteLength()
+, quantize()
+, quantizeVectorBits(8)
+, compression(Compression_None)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+bool BufferBuilder :: CanWriteIndices(const aiMesh& mesh)
+{
+	return GetIndicesPerFace(mesh) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int BufferBuilder :: AddMeshStream(const aiMesh& mesh, Source source, unsigned int channel)
+{
+	Accessor acc;
+	acc.bufferView = static_cast<unsigned int>(bufferViews.size());
+	acc.componentType = WebGL::FLOAT;
+	acc.count = mesh.mNumVertices;
+	acc.normalized = false;
+	acc.hasBounds = false;
+	acc.encoding = Encoding_None;
+
+	BufferView view;
+	view.target = WebGL::ARRAY_BUFFER;
+	view.filter = Filter_None;
+	view.deflated = false;
+	view.byteStride = 0;
+	view.decodedLength = 0;
+
+	size_t component_size = sizeof(float);
+	switch (source)
+	{
+	case Source_Positions:
+		acc.numComponents = 3;
+		break;
+
+	case Source_Normals:
+	case Source_Tangents:
+	case Source_Bitangents:
+		acc.numComponents = 3;
+		if (quantize) {
+			acc.normalized = true;
+			if (quantizeVectorBits == 8) {
+				acc.encoding = Encoding_Octahedral;
+				acc.componentType = WebGL::BYTE;
+				acc.numComponents = 2;
+				component_size = sizeof(signed char);
+			}
+			else {
+				acc.componentType = WebGL::SHORT;
+				component_size = sizeof(short);
+			}
+		}
+		break;
+
+	case Source_TextureCoords:
+		acc.numComponents = GetNumUVComponents(mesh, channel);
+		break;
+
+	case Source_Colors:
+		acc.numComponents = 4;
+		break;
+
+	case Source_Indices:
+		assert(CanWriteIndices(mesh));
+
+		// highest index must fit into the index type
+		if (mesh.mNumVertices <= static_cast<unsigned int>(std::numeric_limits<unsigned short>::max()) + 1) {
+			acc.componentType = WebGL::UNSIGNED_SHORT;
+			component_size = sizeof(unsigned short);
+		}
+		else {
+			acc.componentType = WebGL::UNSIGNED_INT;
+			component_size = sizeof(unsigned int);
+		}
+		acc.count = mesh.mNumFaces * GetIndicesPerFace(mesh);
+		acc.numComponents = 1;
+		view.target = WebGL::ELEMENT_ARRAY_BUFFER;
+		break;
+
+	default:
+		assert(false);
+	}
+
+	// glTF requires bounds for vertex positions
+	if (source == Source_Positions) {
+		acc.hasBounds = true;
+		ComputeBounds(mesh.mVertices, mesh.mNumVertices, 3, acc.min, acc.max);
+	}
+
+	// quantized positions and UVs are relative to the bounds of the stream,
+	// which the accessor then reports in quantized units.
+	if (quantize && mesh.mNumVertices && (source == Source_Positions || source == Source_TextureCoords)) {
+		acc.encoding = Encoding_Linear;
+		acc.componentType = WebGL::UNSIGNED_SHORT;
+		component_size = sizeof(unsigned short);
+
+		ComputeBounds(GetVectors(mesh, source, channel), mesh.mNumVertices, acc.numComponents, acc.decodedMin, acc.decodedMax);
+
+		acc.hasBounds = true;
+		for (unsigned int c = 0; c < acc.numComponents; ++c) {
+			acc.min[c] = 0.f;
+			acc.max[c] = acc.decodedMax[c] > acc.decodedMin[c] ? 65535.f : 0.f;
+		}
+	}
+
+	view.byteOffset = (byteLength + kViewAlignment - 1) & ~(kViewAlignment - 1);
+	view.byteLength = component_size * acc.numComponents * acc.count;
+	byteLength = view.byteOffset + view.byteLength;
+
+	Segment seg;
+	seg.mesh = &mesh;
+	seg.source = source;
+	seg.channel = channel;
+	seg.accessor = static_cast<unsigned int>(accessors.size());
+	seg.bufferView = acc.bufferView;
+	seg.data = NULL;
+	seg.size = 0;
+
+	segments.push_back(seg);
+	bufferViews.push_back(view);
+	accessors.push_back(acc);
+	return seg.accessor;
+}
+
+// ------------------------------------------------------------------------------------------------
+void BufferBuilder :: AddMesh(const aiMesh& mesh, MeshAccessors& out)
+{
+	out.positions = AddMeshStream(mesh, Source_Positions);
+	out.normals = mesh.HasNormals() ? AddMeshStream(mesh, Source_Normals) : NO_ACCESSOR;
+
+	out.tangents = out.bitangents = NO_ACCESSOR;
+	if (mesh.HasTangentsAndBitangents()) {
+		out.tangents = AddMeshStream(mesh, Source_Tangents);
+		out.bitangents = AddMeshStream(mesh, Source_Bitangents);
+	}
+
+	for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+		out.texturecoords[c] = c < mesh.GetNumUVChannels() ? AddMeshStream(mesh, Source_TextureCoords, c) : NO_ACCESSOR;
+	}
+
+	for (unsigned int c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c) {
+		out.colors[c] = c < mesh.GetNumColorChannels() ? AddMeshStream(mesh, Source_Colors, c) : NO_ACCESSOR;
+	}
+
+	out.indices = CanWriteIndices(mesh) ? AddMeshStream(mesh, Source_Indices) : NO_ACCESSOR;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int BufferBuilder :: AddBlob(const void* data, size_t size)
+{
+	BufferView view;
+	view.byteOffset = (byteLength + kViewAlignment - 1) & ~(kViewAlignment - 1);
+	view.byteLength = size;
+	view.target = 0;
+	view.filter = Filter_None;
+	view.deflated = false;
+	view.byteStride = 0;
+	view.decodedLength = 0;
+	byteLength = view.byteOffset + view.byteLength;
+
+	Segment seg;
+	seg.mesh = NULL;
+	seg.source = Source_Blob;
+	seg.channel = 0;
+	seg.accessor = NO_ACCESSOR;
+	seg.bufferView = static_cast<unsigned int>(bufferViews.size());
+	seg.data = static_cast<const unsigned char*>(data);
+	seg.size = size;
+
+	segments.push_back(seg);
+	bufferViews.push_back(view);
+	return seg.bufferView;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int BufferBuilder :: AddBlob(std::vector<unsigned char>& data)
+{
+	ownedBlobs.push_back(std::vector<unsigned char>());
+	ownedBlobs.back().swap(data);
+
+	const std::vector<unsigned char>& blob = ownedBlobs.back();
+	return AddBlob(blob.empty() ? NULL : &blob[0], blob.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+void BufferBuilder :: WritePayload(Assimp::IOStream& out) const
+{
+	static const char padding[kViewAlignment] = {};
+
+	size_t cursor = 0;
+	for (std::vector<Segment>::const_iterator it = segments.begin(), end = segments.end(); it != end; ++it) {
+		const BufferView& view = bufferViews[(*it).bufferView];
+		if (view.byteOffset > cursor) {
+			out.Write(padding, 1, view.byteOffset - cursor);
+		}
+
+		if (encoded.empty()) {
+			WriteSegment(out, *it);
+		}
+		else {
+			const std::vector<unsigned char>& data = encoded[it - segments.begin()];
+			if (!data.empty()) {
+				out.Write(&data[0], 1, data.size());
+			}
+		}
+		cursor = view.byteOffset + view.byteLength;
+	}
+	assert(cursor == byteLength);
+}
+
+// ------------------------------------------------------------------------------------------------
+void BufferBuilder :: Compress(Assimp::WorkerPool& pool)
+{
+	if (compression == Compression_None || segments.empty()) {
+		return;
+	}
+
+	encoded.resize(segments.size());
+	pool.ParallelFor(static_cast<unsigned int>(segments.size()), [this](unsigned int i) {
+		EncodeSegment(i);
+	});
+
+	// lay out the views again with their encoded sizes
+	byteLength = 0;
+	for (size_t i = 0; i < segments.size(); ++i) {
+		BufferView& view = bufferViews[segments[i].bufferView];
+
+		view.byteOffset = (byteLength + kViewAlignment - 1) & ~(kViewAlignment - 1);
+		view.byteLength = encoded[i].size();
+		byteLength = view.byteOffset + view.byteLength;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void BufferBuilder :: EncodeSegment(unsigned int index)
+{
+	const Segment& seg = segments[index];
+	std::vector<unsigned char>& out = encoded[index];
+
+	// blobs are images, which come compressed already
+	if (seg.source == Source_Blob) {
+		out.assign(seg.data, seg.data + seg.size);
+		return;
+	}
+
+	const Accessor& acc = accessors[seg.accessor];
+	BufferView& view = bufferViews[acc.bufferView];
+
+	std::vector<unsigned char> raw;
+	raw.reserve(view.byteLength);
+
+	VectorIOStream stream(raw);
+	WriteSegment(stream, seg);
+
+	const unsigned int component_size = GetComponentSize(acc.componentType);
+
+	if (view.target == WebGL::ELEMENT_ARRAY_BUFFER) {
+		view.filter = Filter_IndexDelta;
+		view.byteStride = component_size;
+		EncodeIndexDeltas(raw.empty() ? NULL : &raw[0], raw.size(), component_size, out);
+	}
+	else {
+		view.filter = Filter_VertexDelta;
+		view.byteStride = component_size * acc.numComponents;
+		EncodeVertexDeltas(raw.empty() ? NULL : &raw[0], raw.size(), view.byteStride, component_size, out);
+	}
+	view.decodedLength = raw.size();
+
+	if (compression == Compression_Deflate) {
+		// raw is no longer needed, reuse it for the output
+		if (Deflate(out, raw)) {
+			out.swap(raw);
+			view.deflated = true;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void BufferBuilder :: WriteSegment(Assimp::IOStream& out, const Segment& seg) const
+{
+	if (seg.source == Source_Blob) {
+		if (seg.size) {
+			out.Write(seg.data, 1, seg.size);
+		}
+		return;
+	}
+
+	const aiMesh& mesh = *seg.mesh;
+	const Accessor& acc = accessors[seg.accessor];
+
+	if (acc.encoding == Encoding_Linear) {
+		WriteLinear16(out, GetVectors(mesh, seg.source, seg.channel), mesh.mNumVertices, acc.numComponents, acc.decodedMin, acc.decodedMax);
+		return;
+	}
+	if (acc.encoding == Encoding_Octahedral) {
+		WriteOctahedral8(out, GetVectors(mesh, seg.source, seg.channel), mesh.mNumVertices);
+		return;
+	}
+	if (acc.componentType == WebGL::SHORT) {
+		WriteSnorm16(out, GetVectors(mesh, seg.source, seg.channel), mesh.mNumVertices);
+		return;
+	}
+
+	// aiVector3D and aiColor4D are tightly packed floats, so most streams
+	// can be written without any intermediate copy.
+	switch (seg.source)
+	{
+	case Source_Positions:
+		out.Write(mesh.mVertices, sizeof(aiVector3D), mesh.mNumVertices);
+		break;
+
+	case Source_Normals:
+		out.Write(mesh.mNormals, sizeof(aiVector3D), mesh.mNumVertices);
+		break;
+
+	case Source_Tangents:
+		out.Write(mesh.mTangents, sizeof(aiVector3D), mesh.mNumVertices);
+		break;
+
+	case Source_Bitangents:
+		out.Write(mesh.mBitangents, sizeof(aiVector3D), mesh.mNumVertices);
+		break;
+
+	case Source_TextureCoords:
+		{
+			const unsigned int numc = GetNumUVComponents(mesh, seg.channel);
+			if (numc == 3) {
+				out.Write(mesh.mTextureCoords[seg.channel], sizeof(aiVector3D), mesh.mNumVertices);
+			}
+			else {
+				WriteTextureCoords(out, mesh.mTextureCoords[seg.channel], mesh.mNumVertices, numc);
+			}
+		}
+		break;
+
+	case Source_Colors:
+		out.Write(mesh.mColors[seg.channel], sizeof(aiColor4D), mesh.mNumVertices);
+		break;
+
+	case Source_Indices:
+		if (acc.componentType == WebGL::UNSIGNED_SHORT) {
+			WriteIndices<unsigned short>(out, mesh);
+		}
+		else {
+			WriteIndices<unsigned int>(out, mesh);
+		}
+		break;
+
+	default:
+		assert(false);
+	}
+}
@@ -0,0 +1,277 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_BUFFER_BUILDER
+#define INCLUDED_BUFFER_BUILDER
+
+#include <vector>
+#include <list>
+#include <cstddef>
+
+#include <assimp/mesh.h>
+
+namespace Assimp {
+	class IOStream;
+	class WorkerPool;
+}
+
+// WebGL enums (FLOAT, UNSIGNED_SHORT, ARRAY_BUFFER, ...) as used by glTF.
+// Kept in a namespace of their own so they can't clash with platform
+// headers which #define or typedef the same names.
+namespace WebGL {
+	typedef unsigned int GLenum;
+#	include "webgl-idl.h"
+}
+
+// ---------------------------------------------------------------------------
+/** Collects the vertex and index streams of a scene into a single glTF
+ *  buffer and keeps track of the bufferViews and accessors describing
+ *  them.
+ *
+ *  Adding a stream only records where its data lives in the source mesh
+ *  and where it will end up in the buffer, no data is copied at that
+ *  point. The actual payload is produced by WritePayload(), which reads
+ *  straight from the aiMesh arrays. The meshes must therefore stay alive
+ *  until the payload has been written.
+ */
+class BufferBuilder
+{
+public:
+
+	enum Source
+	{
+		Source_Positions,
+		Source_Normals,
+		Source_Tangents,
+		Source_Bitangents,
+		Source_TextureCoords,
+		Source_Colors,
+		Source_Indices,
+
+		// raw bytes, i.e. an image file
+		Source_Blob
+	};
+
+	enum Encoding
+	{
+		// plain values
+		Encoding_None,
+
+		// unsigned shorts mapped linearly onto [decodedMin,decodedMax]
+		// as in the WEB3D_quantized_attributes extension
+		Encoding_Linear,
+
+		// normalized bytes holding an octahedral mapping of unit vectors
+		Encoding_Octahedral
+	};
+
+	enum Compression
+	{
+		Compression_None,
+
+		// delta filters only, leaving entropy coding to the transport
+		Compression_Filter,
+
+		// delta filters followed by zlib
+		Compression_Deflate
+	};
+
+	enum Filter
+	{
+		Filter_None,
+		Filter_IndexDelta,
+		Filter_VertexDelta
+	};
+
+	struct BufferView
+	{
+		size_t byteOffset;
+		size_t byteLength;
+
+		// 0 for data which isn't vertex or index data
+		WebGL::GLenum target;
+
+		// encoding of the data in the buffer, see Compress()
+		Filter filter;
+		bool deflated;
+
+		// size of one element before filtering, and size of the data
+		// after decoding. Only valid if filter isn't Filter_None.
+		unsigned int byteStride;
+		size_t decodedLength;
+	};
+
+	struct Accessor
+	{
+		unsigned int bufferView;
+		WebGL::GLenum componentType;
+		unsigned int count;
+
+		// number of components per element, i.e. 1 for SCALAR, 3 for VEC3
+		unsigned int numComponents;
+
+		// integer components map to [-1,1] or [0,1] respectively
+		bool normalized;
+
+		// per-component bounds, only valid if hasBounds is set
+		bool hasBounds;
+		float min[4], max[4];
+
+		Encoding encoding;
+
+		// bounds of the decoded values, only valid for Encoding_Linear
+		float decodedMin[4], decodedMax[4];
+	};
+
+	/** Accessor indices for all streams of a mesh */
+	struct MeshAccessors
+	{
+		unsigned int positions, normals, tangents, bitangents;
+		unsigned int texturecoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+		unsigned int colors[AI_MAX_NUMBER_OF_COLOR_SETS];
+
+		// NO_ACCESSOR if the faces can't be written as index stream
+		unsigned int indices;
+	};
+
+	static const unsigned int NO_ACCESSOR = 0xffffffff;
+
+public:
+
+	BufferBuilder();
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Enable vertex quantization for streams added after this call.
+	 *
+	 *  Positions and texture coordinates are stored as unsigned shorts
+	 *  relative to the bounds of each stream. Normals, tangents and
+	 *  bitangents are stored as octahedral normalized bytes if
+	 *  vector_bits is 8, or as normalized shorts if it is 16. Vertex colors
+	 *  are always written as floats.
+	 */
+	void SetQuantization(bool enable, unsigned int vector_bits = 8) {
+		quantize = enable;
+		quantizeVectorBits = vector_bits;
+	}
+
+	void SetCompression(Compression c) {
+		compression = c;
+	}
+
+	// -------------------------------------------------------------------
+	/** Check whether the face indices of a mesh can be represented as
+	 *  a flat index stream, i.e. all faces are of the same type.
+	 */
+	static bool CanWriteIndices(const aiMesh& mesh);
+
+	// -------------------------------------------------------------------
+	/** Schedule a mesh stream for output.
+	 *  @param mesh Source mesh, must outlive the BufferBuilder.
+	 *  @param source Stream to be written.
+	 *  @param channel UV or color channel, ignored for other sources.
+	 *  @return Index of the accessor referencing the stream.
+	 */
+	unsigned int AddMeshStream(const aiMesh& mesh, Source source, unsigned int channel = 0);
+
+	// -------------------------------------------------------------------
+	/** Schedule all streams of a mesh for output.
+	 *  @param mesh Source mesh, must outlive the BufferBuilder.
+	 *  @param out Receives the accessor indices of the streams, streams
+	 *    the mesh doesn't have are set to NO_ACCESSOR.
+	 */
+	void AddMesh(const aiMesh& mesh, MeshAccessors& out);
+
+	// -------------------------------------------------------------------
+	/** Schedule raw bytes for output, i.e. an image file.
+	 *  @param data Must stay valid until the payload has been written.
+	 *  @return Index of the bufferView holding the data.
+	 */
+	unsigned int AddBlob(const void* data, size_t size);
+
+	// -------------------------------------------------------------------
+	/** Schedule raw bytes for output, taking over their storage.
+	 *  @param data Moved into the BufferBuilder, left empty.
+	 *  @return Index of the bufferView holding the data.
+	 */
+	unsigned int AddBlob(std::vector<unsigned char>& data);
+
+	// -------------------------------------------------------------------
+	/** Encode all streams added so far as set by SetCompression().
+	 *
+	 *  This renders the streams into memory and updates the bufferViews
+	 *  to the encoded sizes, so it must be called after the last stream
+	 *  has been added and before the bufferViews are used. Accessors keep
+	 *  referring to the decoded data. No-op for Compression_None.
+	 */
+	void Compress(Assimp::WorkerPool& pool);
+
+	// -------------------------------------------------------------------
+	/** Write the binary payload for all streams added so far.
+	 *  Exactly GetByteLength() bytes are written.
+	 */
+	void WritePayload(Assimp::IOStream& out) const;
+
+public:
+
+	size_t GetByteLength() const {
+		return byteLength;
+	}
+
+	const std::vector<BufferView>& GetBufferViews() const {
+		return bufferViews;
+	}
+
+	const std::vector<Accessor>& GetAccessors() const {
+		return accessors;
+	}
+
+private:
+
+	struct Segment
+	{
+		const aiMesh* mesh;
+		Source source;
+		unsigned int channel;
+
+		// index into accessors, NO_ACCESSOR for blobs
+		unsigned int accessor;
+		unsigned int bufferView;
+
+		// Source_Blob only
+		const unsigned char* data;
+		size_t size;
+	};
+
+	void WriteSegment(Assimp::IOStream& out, const Segment& seg) const;
+	void EncodeSegment(unsigned int index);
+
+private:
+
+	size_t byteLength;
+
+	bool quantize;
+	unsigned int quantizeVectorBits;
+
+	Compression compression;
+
+	std::vector<Segment> segments;
+
+	// encoded payload per segment, only filled by Compress()
+	std::vector< std::vector<unsigned char> > encoded;
+
+	// blobs passed to AddBlob() by value
+	std::list< std::vector<unsigned char> > ownedBlobs;
+
+	std::vector<BufferView> bufferViews;
+	std::vector<Accessor> accessors;
+};
+
+#endif // INCLUDED_BUFFER_BUILDER
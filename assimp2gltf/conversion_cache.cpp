@@ -0,0 +1,358 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "conversion_cache.h"
+#include "gltf_config.h"
+#include "import_settings.h"
+
+#include <assimp/Exporter.hpp>
+#include <assimp/version.h>
+#include <assimp/../../code/Hash.h>
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#	include <direct.h>
+#	include <windows.h>
+#else
+#	include <sys/stat.h>
+#endif
+#ifdef __APPLE__
+#	include <mach-o/dyld.h>
+#endif
+
+namespace {
+
+const char* const kManifestHeader = "assimp2gltf-cache 1";
+
+// ------------------------------------------------------------------------------------------------
+// Gives access to the property maps to hash them
+class HashableProperties : public Assimp::ExportProperties
+{
+public:
+
+	explicit HashableProperties(const Assimp::ExportProperties& other)
+		: Assimp::ExportProperties(other)
+	{}
+
+	uint64_t Hash(uint64_t hash) const
+	{
+		// the output doesn't depend on the thread count, so all counts share entries
+		const KeyType threads = SuperFastHash(AI_CONFIG_EXPORT_GLTF_THREADS);
+		for (IntPropertyMap::const_iterator it = mIntProperties.begin(); it != mIntProperties.end(); ++it) {
+			if ((*it).first != threads) {
+				hash = HashPair(hash, 'i', (*it).first, &(*it).second, sizeof(int));
+			}
+		}
+		for (FloatPropertyMap::const_iterator it = mFloatProperties.begin(); it != mFloatProperties.end(); ++it) {
+			hash = HashPair(hash, 'f', (*it).first, &(*it).second, sizeof(float));
+		}
+		for (StringPropertyMap::const_iterator it = mStringProperties.begin(); it != mStringProperties.end(); ++it) {
+			hash = HashPair(hash, 's', (*it).first, (*it).second.data(), (*it).second.size());
+		}
+		for (MatrixPropertyMap::const_iterator it = mMatrixProperties.begin(); it != mMatrixProperties.end(); ++it) {
+			hash = HashPair(hash, 'm', (*it).first, &(*it).second, sizeof(aiMatrix4x4));
+		}
+		return hash;
+	}
+
+private:
+
+	static uint64_t HashPair(uint64_t hash, char type, KeyType key, const void* value, size_t size)
+	{
+		hash = XXHash64(&type, 1, hash);
+		hash = XXHash64(&key, sizeof(key), hash);
+		return XXHash64(value, size, hash);
+	}
+};
+
+// ------------------------------------------------------------------------------------------------
+bool HashFile(const std::string& file, uint64_t& hash)
+{
+	FILE* const f = ::fopen(file.c_str(), "rb");
+	if (!f) {
+		return false;
+	}
+
+	std::vector<char> buffer(1 << 20);
+	for (size_t size; (size = ::fread(&buffer[0], 1, buffer.size(), f)) > 0; ) {
+		hash = XXHash64(&buffer[0], size, hash);
+	}
+
+	const bool ok = !::ferror(f);
+	::fclose(f);
+	return ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool CopyFileContents(const std::string& from, const std::string& to)
+{
+	FILE* const in = ::fopen(from.c_str(), "rb");
+	if (!in) {
+		return false;
+	}
+	FILE* const out = ::fopen(to.c_str(), "wb");
+	if (!out) {
+		::fclose(in);
+		return false;
+	}
+
+	std::vector<char> buffer(1 << 20);
+	bool ok = true;
+	for (size_t size; ok && (size = ::fread(&buffer[0], 1, buffer.size(), in)) > 0; ) {
+		ok = ::fwrite(&buffer[0], 1, size, out) == size;
+	}
+
+	ok = ok && !::ferror(in);
+	::fclose(in);
+	return ::fclose(out) == 0 && ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the directory part of a file name, including the trailing separator
+std::string GetDirectory(const std::string& file)
+{
+	const std::string::size_type sep = file.find_last_of("/\\");
+	return sep == std::string::npos ? std::string() : file.substr(0, sep + 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the absolute path of an existing file with all links resolved, so each file has one name
+bool GetCanonicalPath(const std::string& file, std::string& path)
+{
+#ifdef _WIN32
+	char buffer[_MAX_PATH];
+	if (!_fullpath(buffer, file.c_str(), _MAX_PATH)) {
+		return false;
+	}
+#else
+	char buffer[PATH_MAX];
+	if (!realpath(file.c_str(), buffer)) {
+		return false;
+	}
+#endif
+	path = buffer;
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the file of the running executable, empty if it can't be found
+std::string GetExecutableFile()
+{
+#if defined(_WIN32)
+	char buffer[MAX_PATH];
+	const DWORD size = GetModuleFileNameA(NULL, buffer, MAX_PATH);
+	return size > 0 && size < MAX_PATH ? std::string(buffer, size) : std::string();
+#elif defined(__APPLE__)
+	char buffer[PATH_MAX];
+	uint32_t size = PATH_MAX;
+	return _NSGetExecutablePath(buffer, &size) == 0 ? std::string(buffer) : std::string();
+#elif defined(__linux__)
+	return "/proc/self/exe";
+#else
+	return std::string();
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string ToHex(uint64_t v)
+{
+	char buffer[17];
+	::sprintf(buffer, "%08x%08x", static_cast<unsigned int>(v >> 32), static_cast<unsigned int>(v));
+	return buffer;
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+bool RecordingIOSystem :: Exists(const char* pFile) const
+{
+	const bool exists = Assimp::DefaultIOSystem::Exists(pFile);
+	reads.insert(std::make_pair(std::string(pFile), exists));
+	return exists;
+}
+
+// ------------------------------------------------------------------------------------------------
+Assimp::IOStream* RecordingIOSystem :: Open(const char* pFile, const char* pMode)
+{
+	Assimp::IOStream* const stream = Assimp::DefaultIOSystem::Open(pFile, pMode);
+	if (strchr(pMode, 'w')) {
+		if (stream) {
+			writes.push_back(pFile);
+		}
+	}
+	else {
+		reads[pFile] = stream != NULL;
+	}
+	return stream;
+}
+
+// ------------------------------------------------------------------------------------------------
+ConversionCache :: ConversionCache(const std::string& dir, const char* format, const PostProcessing& pp,
+	const Assimp::ExportProperties& props)
+	: dir(dir)
+{
+	// the executable stands in for the version of all the code involved, it changes
+	// with every build that changes any of it. If it can't be read, fall back to the
+	// build time of this file, which misses rebuilds that leave this file alone.
+	uint64_t build = XXHash64(kManifestHeader, strlen(kManifestHeader));
+	const std::string exe = GetExecutableFile();
+	if (exe.empty() || !HashFile(exe, build)) {
+		const std::string stamp = std::string(__DATE__) + "." + __TIME__;
+		build = XXHash64(stamp.data(), stamp.size(), build);
+	}
+
+	const unsigned int version[] = { aiGetVersionMajor(), aiGetVersionMinor(), aiGetVersionRevision(),
+		pp.flags, pp.adaptive, pp.exact_weld };
+
+	settings = XXHash64(version, sizeof(version), build);
+	settings = XXHash64(format, strlen(format), settings);
+	settings = HashableProperties(props).Hash(settings);
+
+#ifdef _WIN32
+	_mkdir(dir.c_str());
+#else
+	mkdir(dir.c_str(), 0777);
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ConversionCache :: GetKey(const std::string& in, const std::string& out, uint64_t& key) const
+{
+	// the output file name matters as the json refers to its .bin file by name
+	const std::string name = out.substr(GetDirectory(out).size());
+
+	// and the input file name as the importer looks for other files relative to it.
+	// The manifest only lists the files one conversion of the same contents found.
+	std::string path;
+	if (!GetCanonicalPath(in, path)) {
+		return false;
+	}
+
+	key = XXHash64(name.data(), name.size(), settings);
+	key = XXHash64(path.data(), path.size(), key);
+	return HashFile(in, key);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ConversionCache :: Restore(uint64_t key, const std::string& out) const
+{
+	std::ifstream manifest(GetEntryFile(key, ".manifest").c_str());
+
+	std::string line;
+	if (!std::getline(manifest, line) || line != kManifestHeader) {
+		return false;
+	}
+
+	std::vector<std::string> outputs;
+	while (std::getline(manifest, line)) {
+		const std::string::size_type sep = line.find(' ');
+		if (sep == std::string::npos) {
+			return false;
+		}
+
+		const std::string type = line.substr(0, sep);
+		if (type == "write") {
+			outputs.push_back(line.substr(sep + 1));
+		}
+		else if (type == "absent") {
+			uint64_t dummy = 0;
+			if (HashFile(line.substr(sep + 1), dummy)) {
+				return false;
+			}
+		}
+		else if (type == "read" && line.size() > sep + 18) {
+			uint64_t hash = 0;
+			if (!HashFile(line.substr(sep + 18), hash) || ToHex(hash) != line.substr(sep + 1, 16)) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+	}
+
+	if (outputs.empty()) {
+		return false;
+	}
+
+	const std::string out_dir = GetDirectory(out);
+	for (size_t i = 0; i < outputs.size(); ++i) {
+		std::ostringstream ss;
+		ss << "." << i;
+		if (!CopyFileContents(GetEntryFile(key, ss.str().c_str()), out_dir + outputs[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ConversionCache :: Store(uint64_t key, const std::string& out, const RecordingIOSystem& import_io,
+	const RecordingIOSystem& export_io) const
+{
+	const std::string out_dir = GetDirectory(out);
+
+	std::ostringstream manifest;
+	manifest << kManifestHeader << "\n";
+
+	const std::map<std::string, bool>& reads = import_io.GetReads();
+	for (std::map<std::string, bool>::const_iterator it = reads.begin(); it != reads.end(); ++it) {
+		uint64_t hash = 0;
+		if (!(*it).second) {
+			manifest << "absent " << (*it).first << "\n";
+		}
+		else if (HashFile((*it).first, hash)) {
+			manifest << "read " << ToHex(hash) << " " << (*it).first << "\n";
+		}
+		else {
+			return;
+		}
+	}
+
+	// outputs are restored next to the output file, so all of them must be there
+	const std::vector<std::string>& writes = export_io.GetWrites();
+	for (size_t i = 0; i < writes.size(); ++i) {
+		const std::string& file = writes[i];
+		if (file.compare(0, out_dir.size(), out_dir) || GetDirectory(file) != out_dir) {
+			return;
+		}
+
+		std::ostringstream ss;
+		ss << "." << i;
+		if (!CopyFileContents(file, GetEntryFile(key, ss.str().c_str()))) {
+			return;
+		}
+		manifest << "write " << file.substr(out_dir.size()) << "\n";
+	}
+
+	// the manifest goes last, an entry without one is never used
+	const std::string manifest_file = GetEntryFile(key, ".manifest");
+	const std::string temp_file = GetEntryFile(key, ".manifest.tmp");
+	{
+		std::ofstream f(temp_file.c_str());
+		f << manifest.str();
+		if (!f) {
+			return;
+		}
+	}
+	::remove(manifest_file.c_str());
+	::rename(temp_file.c_str(), manifest_file.c_str());
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string ConversionCache :: GetEntryFile(uint64_t key, const char* suffix) const
+{
+	return dir + "/" + ToHex(key) + suffix;
+}
@@ -0,0 +1,107 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_CONVERSION_CACHE
+#define INCLUDED_CONVERSION_CACHE
+
+#include <assimp/../../code/DefaultIOSystem.h>
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct PostProcessing;
+namespace Assimp {
+	class ExportProperties;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Plain file IO which remembers the files it was asked about, used to find out
+ *  which files an import depended on and which files an export produced.
+ */
+class RecordingIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+
+	bool Exists(const char* pFile) const;
+	Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb");
+
+public:
+
+	void Clear() {
+		reads.clear();
+		writes.clear();
+	}
+
+	/** Files looked up or opened for reading, mapped to whether they existed */
+	const std::map<std::string, bool>& GetReads() const {
+		return reads;
+	}
+
+	/** Files opened for writing, in order */
+	const std::vector<std::string>& GetWrites() const {
+		return writes;
+	}
+
+private:
+
+	mutable std::map<std::string, bool> reads;
+	std::vector<std::string> writes;
+};
+
+
+// ------------------------------------------------------------------------------------------------
+/** On-disk cache of conversion results, keyed on the contents and location of the
+ *  input file and everything that affects the output: the output format and file name,
+ *  the post processing, the export properties and the build of the tool.
+ *
+ *  Each entry also lists every other file the importer looked at, with a hash of
+ *  its contents (or a note that it did not exist). An entry is only used if all
+ *  of them are still the same.
+ *
+ *  Lookups and stores for different keys may run on different threads.
+ */
+class ConversionCache
+{
+public:
+
+	ConversionCache(const std::string& dir, const char* format, const PostProcessing& pp,
+		const Assimp::ExportProperties& props);
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Get the cache key for converting in to out. Returns false if the
+	 *  input file can't be read. */
+	bool GetKey(const std::string& in, const std::string& out, uint64_t& key) const;
+
+	// -------------------------------------------------------------------
+	/** Write the cached output files for key next to out. Returns false if
+	 *  there is no valid entry. */
+	bool Restore(uint64_t key, const std::string& out) const;
+
+	// -------------------------------------------------------------------
+	/** Store the result of a successful conversion to out.
+	 *  @param import_io IO system used by the importer
+	 *  @param export_io IO system used by the exporter */
+	void Store(uint64_t key, const std::string& out, const RecordingIOSystem& import_io,
+		const RecordingIOSystem& export_io) const;
+
+private:
+
+	std::string GetEntryFile(uint64_t key, const char* suffix) const;
+
+private:
+
+	std::string dir;
+	uint64_t settings;
+};
+
+#endif // INCLUDED_CONVERSION_CACHE
@@ -0,0 +1,319 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "deduplicator.h"
+#include "mesh_splitter.h"
+
+#include <assimp/scene.h>
+#include <assimp/../../code/Hash.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Fill unique and map for count items, given the hash of each item and a function to compare
+// two of them by their index.
+template <typename HashFunc, typename EqualFunc>
+void FindUnique(unsigned int count, std::vector<unsigned int>& unique, std::vector<unsigned int>& map,
+	const HashFunc& hash, const EqualFunc& equal)
+{
+	unique.clear();
+	map.resize(count);
+
+	// positions in unique of the items with a given hash
+	std::unordered_map<uint64_t, std::vector<unsigned int> > buckets;
+	buckets.reserve(count);
+
+	for (unsigned int i = 0; i < count; ++i) {
+		std::vector<unsigned int>& bucket = buckets[hash(i)];
+
+		std::vector<unsigned int>::const_iterator it = bucket.begin();
+		while (it != bucket.end() && !equal(unique[*it], i)) {
+			++it;
+		}
+
+		if (it != bucket.end()) {
+			map[i] = *it;
+		}
+		else {
+			map[i] = static_cast<unsigned int>(unique.size());
+			bucket.push_back(map[i]);
+			unique.push_back(i);
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+uint64_t HashArray(const T* data, unsigned int count, uint64_t hash)
+{
+	const uint32_t present = data != NULL;
+	hash = XXHash64(&present, sizeof(present), hash);
+	return data ? XXHash64(data, sizeof(T) * count, hash) : hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Bitwise comparison, which is what matters for the output
+template <typename T>
+bool CompareArrays(const T* a, const T* b, unsigned int count)
+{
+	if (!a || !b) {
+		return a == b;
+	}
+	return !memcmp(a, b, sizeof(T) * count);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the embedded texture a material property refers to, if any
+bool GetEmbeddedTexture(const aiMaterialProperty& prop, unsigned int& index)
+{
+	if (prop.mType != aiPTI_String || strcmp(prop.mKey.C_Str(), _AI_MATKEY_TEXTURE_BASE)) {
+		return false;
+	}
+
+	// strings are stored as 32 bit length followed by the characters
+	const char* const s = prop.mData + 4;
+	if (s[0] != '*') {
+		return false;
+	}
+	index = static_cast<unsigned int>(strtoul(s + 1, NULL, 10));
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t GetTextureSize(const aiTexture& tex)
+{
+	return tex.mHeight ? tex.mWidth * tex.mHeight * sizeof(aiTexel) : tex.mWidth;
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+void UniqueContent::Table :: SetIdentity(unsigned int count)
+{
+	unique.resize(count);
+	map.resize(count);
+	for (unsigned int i = 0; i < count; ++i) {
+		unique[i] = map[i] = i;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string UniqueContent :: GetTextureFile(const std::string& file) const
+{
+	if (file.empty() || file[0] != '*') {
+		return file;
+	}
+
+	const unsigned int index = static_cast<unsigned int>(strtoul(file.c_str() + 1, NULL, 10));
+	if (index >= textures.map.size()) {
+		return file;
+	}
+
+	std::ostringstream ss;
+	ss << "*" << textures.map[index];
+	return ss.str();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Deduplicator :: Execute(const aiScene* pScene, const SplitMeshList& split, UniqueContent& out)
+{
+	const std::vector<const aiMesh*>& meshes = split.GetMeshes();
+	const unsigned int num_meshes = static_cast<unsigned int>(meshes.size());
+
+	if (!enabled) {
+		out.textures.SetIdentity(pScene->mNumTextures);
+		out.materials.SetIdentity(pScene->mNumMaterials);
+		out.meshes.SetIdentity(num_meshes);
+		return;
+	}
+
+	// textures first, materials and then meshes are compared by what they refer to
+	FindUnique(pScene->mNumTextures, out.textures.unique, out.textures.map,
+		[&](unsigned int i) { return HashTexture(*pScene->mTextures[i]); },
+		[&](unsigned int a, unsigned int b) { return CompareTextures(*pScene->mTextures[a], *pScene->mTextures[b]); });
+
+	FindUnique(pScene->mNumMaterials, out.materials.unique, out.materials.map,
+		[&](unsigned int i) { return HashMaterial(*pScene->mMaterials[i], out); },
+		[&](unsigned int a, unsigned int b) { return CompareMaterials(*pScene->mMaterials[a], *pScene->mMaterials[b], out); });
+
+	FindUnique(num_meshes, out.meshes.unique, out.meshes.map,
+		[&](unsigned int i) { return HashMesh(*meshes[i], out); },
+		[&](unsigned int a, unsigned int b) { return CompareMeshes(*meshes[a], *meshes[b], out); });
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t Deduplicator :: HashTexture(const aiTexture& tex) const
+{
+	const unsigned int header[] = { tex.mWidth, tex.mHeight };
+	uint64_t hash = XXHash64(header, sizeof(header));
+	hash = XXHash64(tex.achFormatHint, sizeof(tex.achFormatHint), hash);
+	return XXHash64(tex.pcData, GetTextureSize(tex), hash);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Deduplicator :: CompareTextures(const aiTexture& a, const aiTexture& b) const
+{
+	return a.mWidth == b.mWidth && a.mHeight == b.mHeight &&
+		!memcmp(a.achFormatHint, b.achFormatHint, sizeof(a.achFormatHint)) &&
+		!memcmp(a.pcData, b.pcData, GetTextureSize(a));
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t Deduplicator :: HashMaterial(const aiMaterial& mat, const UniqueContent& content)
+{
+	uint64_t hash = 0;
+	for (unsigned int i = 0; i < mat.mNumProperties; ++i) {
+		const aiMaterialProperty& prop = *mat.mProperties[i];
+
+		// properties starting with '?' (i.e. the name) don't make materials
+		// different, see the doc for aiMaterialProperty
+		if (prop.mKey.data[0] == '?') {
+			continue;
+		}
+
+		const unsigned int header[] = { prop.mSemantic, prop.mIndex, prop.mType };
+		hash = XXHash64(prop.mKey.data, prop.mKey.length, hash);
+		hash = XXHash64(header, sizeof(header), hash);
+
+		unsigned int texture;
+		if (GetEmbeddedTexture(prop, texture) && texture < content.textures.map.size()) {
+			hash = XXHash64(&content.textures.map[texture], sizeof(unsigned int), hash);
+		}
+		else {
+			hash = XXHash64(prop.mData, prop.mDataLength, hash);
+		}
+	}
+	return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Deduplicator :: CompareMaterials(const aiMaterial& a, const aiMaterial& b, const UniqueContent& content) const
+{
+	unsigned int ia = 0, ib = 0;
+	for (;; ++ia, ++ib) {
+		while (ia < a.mNumProperties && a.mProperties[ia]->mKey.data[0] == '?') {
+			++ia;
+		}
+		while (ib < b.mNumProperties && b.mProperties[ib]->mKey.data[0] == '?') {
+			++ib;
+		}
+		if (ia == a.mNumProperties || ib == b.mNumProperties) {
+			return ia == a.mNumProperties && ib == b.mNumProperties;
+		}
+
+		const aiMaterialProperty& pa = *a.mProperties[ia], &pb = *b.mProperties[ib];
+		if (pa.mKey != pb.mKey || pa.mSemantic != pb.mSemantic || pa.mIndex != pb.mIndex || pa.mType != pb.mType) {
+			return false;
+		}
+
+		unsigned int ta, tb;
+		const bool embedded_a = GetEmbeddedTexture(pa, ta), embedded_b = GetEmbeddedTexture(pb, tb);
+		if (embedded_a && embedded_b && ta < content.textures.map.size() && tb < content.textures.map.size()) {
+			if (content.textures.map[ta] != content.textures.map[tb]) {
+				return false;
+			}
+		}
+		else if (pa.mDataLength != pb.mDataLength || memcmp(pa.mData, pb.mData, pa.mDataLength)) {
+			return false;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t Deduplicator :: HashMesh(const aiMesh& mesh, const UniqueContent& content)
+{
+	const unsigned int header[] = {
+		mesh.mNumVertices, mesh.mNumFaces, mesh.mPrimitiveTypes, content.materials.map[mesh.mMaterialIndex],
+		mesh.mNumBones, mesh.mNumAnimMeshes
+	};
+	uint64_t hash = XXHash64(header, sizeof(header));
+
+	hash = HashArray(mesh.mVertices, mesh.mNumVertices, hash);
+	hash = HashArray(mesh.mNormals, mesh.mNumVertices, hash);
+	hash = HashArray(mesh.mTangents, mesh.mNumVertices, hash);
+	hash = HashArray(mesh.mBitangents, mesh.mNumVertices, hash);
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS; ++n) {
+		hash = HashArray(mesh.mColors[n], mesh.mNumVertices, hash);
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n) {
+		hash = XXHash64(&mesh.mNumUVComponents[n], sizeof(unsigned int), hash);
+		hash = HashArray(mesh.mTextureCoords[n], mesh.mNumVertices, hash);
+	}
+
+	// faces as one stream of sizes and indices
+	indices.clear();
+	for (unsigned int i = 0; i < mesh.mNumFaces; ++i) {
+		const aiFace& face = mesh.mFaces[i];
+		indices.push_back(face.mNumIndices);
+		indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+	}
+	if (!indices.empty()) {
+		hash = XXHash64(&indices[0], indices.size() * sizeof(unsigned int), hash);
+	}
+
+	// bones by name, the weights are left to the comparison
+	for (unsigned int i = 0; i < mesh.mNumBones; ++i) {
+		const aiBone& bone = *mesh.mBones[i];
+		hash = XXHash64(bone.mName.data, bone.mName.length, hash);
+	}
+	return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Deduplicator :: CompareMeshes(const aiMesh& a, const aiMesh& b, const UniqueContent& content) const
+{
+	// animated meshes are never shared
+	if (a.mNumAnimMeshes || b.mNumAnimMeshes) {
+		return false;
+	}
+
+	if (a.mNumVertices != b.mNumVertices || a.mNumFaces != b.mNumFaces || a.mPrimitiveTypes != b.mPrimitiveTypes ||
+		content.materials.map[a.mMaterialIndex] != content.materials.map[b.mMaterialIndex] ||
+		a.mNumBones != b.mNumBones) {
+		return false;
+	}
+
+	const unsigned int num = a.mNumVertices;
+	if (!CompareArrays(a.mVertices, b.mVertices, num) || !CompareArrays(a.mNormals, b.mNormals, num) ||
+		!CompareArrays(a.mTangents, b.mTangents, num) || !CompareArrays(a.mBitangents, b.mBitangents, num)) {
+		return false;
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS; ++n) {
+		if (!CompareArrays(a.mColors[n], b.mColors[n], num)) {
+			return false;
+		}
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n) {
+		if (a.mNumUVComponents[n] != b.mNumUVComponents[n] || !CompareArrays(a.mTextureCoords[n], b.mTextureCoords[n], num)) {
+			return false;
+		}
+	}
+
+	for (unsigned int i = 0; i < a.mNumFaces; ++i) {
+		const aiFace& fa = a.mFaces[i], &fb = b.mFaces[i];
+		if (fa.mNumIndices != fb.mNumIndices || !CompareArrays(fa.mIndices, fb.mIndices, fa.mNumIndices)) {
+			return false;
+		}
+	}
+
+	for (unsigned int i = 0; i < a.mNumBones; ++i) {
+		const aiBone& ba = *a.mBones[i], &bb = *b.mBones[i];
+		if (ba.mName != bb.mName || ba.mNumWeights != bb.mNumWeights ||
+			!CompareArrays(&ba.mOffsetMatrix, &bb.mOffsetMatrix, 1) ||
+			!CompareArrays(ba.mWeights, bb.mWeights, ba.mNumWeights)) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,140 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_DEDUPLICATOR
+#define INCLUDED_DEDUPLICATOR
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct aiScene;
+struct aiMesh;
+struct aiMaterial;
+struct aiTexture;
+class SplitMeshList;
+
+// ---------------------------------------------------------------------------
+/** Mapping of the meshes, materials and textures of a scene to the unique
+ *  ones among them. Each list of unique items holds the index of the first
+ *  occurrence of each distinct item, in order; each map gives the position
+ *  in that list for all items.
+ */
+class UniqueContent
+{
+	friend class Deduplicator;
+
+public:
+
+	/** Output meshes (indices into SplitMeshList::GetMeshes()) to write */
+	const std::vector<unsigned int>& GetMeshes() const {
+		return meshes.unique;
+	}
+
+	/** Position in GetMeshes() of the copy of an output mesh */
+	unsigned int GetMesh(unsigned int mesh) const {
+		return meshes.map[mesh];
+	}
+
+	/** Scene materials to write */
+	const std::vector<unsigned int>& GetMaterials() const {
+		return materials.unique;
+	}
+
+	/** Position in GetMaterials() of the copy of a scene material */
+	unsigned int GetMaterial(unsigned int material) const {
+		return materials.map[material];
+	}
+
+	/** Embedded textures to write */
+	const std::vector<unsigned int>& GetTextures() const {
+		return textures.unique;
+	}
+
+	/** Position in GetTextures() of the copy of an embedded texture */
+	unsigned int GetTexture(unsigned int texture) const {
+		return textures.map[texture];
+	}
+
+	/** Get the texture file to write for a texture file of a material,
+	 *  which differs for references to embedded textures ("*N") */
+	std::string GetTextureFile(const std::string& file) const;
+
+private:
+
+	struct Table
+	{
+		std::vector<unsigned int> unique;
+		std::vector<unsigned int> map;
+
+		void SetIdentity(unsigned int count);
+	};
+
+	Table meshes, materials, textures;
+};
+
+// ---------------------------------------------------------------------------
+/** Finds meshes, materials and embedded textures with identical contents.
+ *
+ *  Items are bucketed by a 64 bit hash of their contents and only
+ *  considered identical after a full comparison. Names play no part,
+ *  identical items are written once under the name of the first one.
+ *  Materials are compared after their references to embedded textures
+ *  are mapped to the unique textures, meshes after their material index
+ *  is mapped to the unique materials.
+ */
+class Deduplicator
+{
+public:
+
+	Deduplicator()
+		: enabled(true)
+	{}
+
+public:
+
+	/** If disabled, all items are taken to be unique */
+	void SetEnabled(bool e) {
+		enabled = e;
+	}
+
+	bool IsEnabled() const {
+		return enabled;
+	}
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Find the unique content of a scene without touching the scene.
+	 * @param pScene The scene to work at.
+	 * @param meshes The meshes written for pScene.
+	 * @param out Receives the mapping to unique items.
+	 */
+	void Execute(const aiScene* pScene, const SplitMeshList& meshes, UniqueContent& out);
+
+private:
+
+	uint64_t HashTexture(const aiTexture& tex) const;
+	bool CompareTextures(const aiTexture& a, const aiTexture& b) const;
+
+	uint64_t HashMaterial(const aiMaterial& mat, const UniqueContent& content);
+	bool CompareMaterials(const aiMaterial& a, const aiMaterial& b, const UniqueContent& content) const;
+
+	uint64_t HashMesh(const aiMesh& mesh, const UniqueContent& content);
+	bool CompareMeshes(const aiMesh& a, const aiMesh& b, const UniqueContent& content) const;
+
+private:
+
+	bool enabled;
+
+	// scratch buffer to hash face indices in one go
+	std::vector<unsigned int> indices;
+};
+
+#endif // INCLUDED_DEDUPLICATOR
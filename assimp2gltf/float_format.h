@@ -0,0 +1,135 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_FLOAT_FORMAT
+#define INCLUDED_FLOAT_FORMAT
+
+// ----------------------------------------------------------------------------
+// Text formatting for single precision values. Most of the scene data is
+// float, printing it through rapidjson's double conversion yields up to 17
+// digits of which only 9 at most carry information.
+// ----------------------------------------------------------------------------
+
+#include "rapidjson/internal/dtoa.h"
+#include "rapidjson/internal/itoa.h"
+
+#include <stdint.h>
+#include <cmath>
+
+// ------------------------------------------------------------------------------------------------
+// Grisu2, as in rapidjson::internal::Grisu2() but with the rounding boundaries of a float. This
+// gives the shortest digit string which still reads back as the same float.
+inline void Grisu2Float(float value, char* buffer, int* length, int* K)
+{
+	using namespace rapidjson::internal;
+
+	union {
+		float f;
+		uint32_t u32;
+	} u = { value };
+
+	const uint64_t kHiddenBit = 0x00800000;
+	const int kExponentBias = 0x7F + 23;
+
+	const int biased_e = static_cast<int>((u.u32 >> 23) & 0xFF);
+	const uint64_t significand = u.u32 & 0x007FFFFF;
+
+	const DiyFp v = biased_e ? DiyFp(significand + kHiddenBit, biased_e - kExponentBias) : DiyFp(significand, 1 - kExponentBias);
+
+	// boundaries are half way to the neighbouring floats
+	const DiyFp w_p = DiyFp((v.f << 1) + 1, v.e - 1).Normalize();
+	DiyFp w_m = (v.f == kHiddenBit) ? DiyFp((v.f << 2) - 1, v.e - 2) : DiyFp((v.f << 1) - 1, v.e - 1);
+	w_m.f <<= w_m.e - w_p.e;
+	w_m.e = w_p.e;
+
+	const DiyFp c_mk = GetCachedPower(w_p.e, K);
+	const DiyFp W = v.Normalize() * c_mk;
+	DiyFp Wp = w_p * c_mk;
+	DiyFp Wm = w_m * c_mk;
+	Wm.f++;
+	Wp.f--;
+	DigitGen(W, Wp, Wp.f - Wm.f, buffer, length, K);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Format a float with the shortest representation that round-trips to the same float. Output
+// follows rapidjson's conventions (i.e. "1.0", "1e30"). The buffer must hold 25 characters.
+inline char* FormatFloat(float value, char* buffer)
+{
+	// leave NaN and infinity to whatever the double path does with them
+	if (value != value || std::fabs(value) > 3.402823466e+38f) {
+		return rapidjson::internal::dtoa(value, buffer);
+	}
+
+	if (value == 0.f) {
+		if (std::signbit(value)) {
+			*buffer++ = '-';
+		}
+		buffer[0] = '0';
+		buffer[1] = '.';
+		buffer[2] = '0';
+		return &buffer[3];
+	}
+
+	if (value < 0.f) {
+		*buffer++ = '-';
+		value = -value;
+	}
+
+	int length, K;
+	Grisu2Float(value, buffer, &length, &K);
+	return rapidjson::internal::Prettify(buffer, length, K);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Format a float rounded to a fixed number of decimal places (0-9), trailing zeros are omitted.
+// Values too large for the given number of decimals fall back to FormatFloat(). The buffer must
+// hold 25 characters.
+inline char* FormatFloatFixed(float value, unsigned int decimals, char* buffer)
+{
+	static const uint64_t kPow10[] = {
+		1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+	};
+	decimals = decimals > 9 ? 9 : decimals;
+
+	const double scaled = std::fabs(static_cast<double>(value)) * kPow10[decimals] + 0.5;
+	if (!(scaled < 9.0e18)) {
+		return FormatFloat(value, buffer);
+	}
+
+	const uint64_t n = static_cast<uint64_t>(scaled);
+	if (!n) {
+		*buffer++ = '0';
+		return buffer;
+	}
+
+	if (value < 0.f) {
+		*buffer++ = '-';
+	}
+	buffer = rapidjson::internal::u64toa(n / kPow10[decimals], buffer);
+
+	uint64_t fraction = n % kPow10[decimals];
+	if (fraction) {
+		unsigned int digits = decimals;
+		while (fraction % 10 == 0) {
+			fraction /= 10;
+			--digits;
+		}
+
+		*buffer++ = '.';
+		for (unsigned int i = digits; i > 0; --i) {
+			buffer[i - 1] = static_cast<char>('0' + fraction % 10);
+			fraction /= 10;
+		}
+		buffer += digits;
+	}
+	return buffer;
+}
+
+#endif // INCLUDED_FLOAT_FORMAT
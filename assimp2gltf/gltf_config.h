@@ -0,0 +1,160 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_GLTF_CONFIG
+#define INCLUDED_GLTF_CONFIG
+
+// ----------------------------------------------------------------------------
+// Export properties understood by the assimp.gltf exporter. Pass them
+// to Assimp::Exporter::Export() through an Assimp::ExportProperties
+// instance, in the same way as the AI_CONFIG_EXPORT_XXX keys in
+// assimp/config.h.
+// ----------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+/** @brief Write vertex and index streams into a binary sidecar file.
+ *
+ * If enabled, positions, normals, tangents, texture coordinates, vertex
+ * colors and face indices are written as raw little-endian data into
+ * a '.bin' file next to the output file. The JSON document then only
+ * references this data through 'buffers', 'bufferViews' and 'accessors'.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_BINARY_BUFFERS "EXPORT_GLTF_BINARY_BUFFERS"
+
+// ---------------------------------------------------------------------------
+/** @brief Number of threads used to serialize meshes and animations.
+ *
+ * Meshes and animations are rendered to text independently and joined
+ * in their original order, the output does not depend on this setting.
+ * 0 uses one thread per hardware thread.
+ * Property type: Integer. Default value: 1.
+ */
+#define AI_CONFIG_EXPORT_GLTF_THREADS "EXPORT_GLTF_THREADS"
+
+// ---------------------------------------------------------------------------
+/** @brief Write the JSON document without indentation and line breaks.
+ *
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_COMPACT "EXPORT_GLTF_COMPACT"
+
+// ---------------------------------------------------------------------------
+/** @brief Number of decimal places for floating-point values in the JSON
+ *  document.
+ *
+ * Values are rounded to the given number of decimal places (0 to 9) and
+ * trailing zeros are dropped. -1 writes each value with the fewest digits
+ * which still read back as the exact same single precision value.
+ * Property type: Integer. Default value: -1.
+ */
+#define AI_CONFIG_EXPORT_GLTF_FLOAT_DECIMALS "EXPORT_GLTF_FLOAT_DECIMALS"
+
+// ---------------------------------------------------------------------------
+/** @brief Quantize vertex streams written to binary buffers.
+ *
+ * Positions and texture coordinates are stored as 16 bit unsigned
+ * integers spanning the bounds of each stream, with the transform back to
+ * the original range given by the WEB3D_quantized_attributes extension
+ * of the accessor. Normals, tangents and bitangents are stored as
+ * normalized integers, see AI_CONFIG_EXPORT_GLTF_QUANTIZE_NORMAL_BITS.
+ * Has no effect unless the vertex data goes to binary buffers.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_QUANTIZE "EXPORT_GLTF_QUANTIZE"
+
+// ---------------------------------------------------------------------------
+/** @brief Precision of quantized normals, tangents and bitangents.
+ *
+ * 8 stores each vector as two normalized bytes in octahedral encoding,
+ * such accessors are marked with "encoding": "octahedral" in their extras.
+ * 16 stores the three components as normalized shorts.
+ * Property type: Integer. Default value: 8.
+ */
+#define AI_CONFIG_EXPORT_GLTF_QUANTIZE_NORMAL_BITS "EXPORT_GLTF_QUANTIZE_NORMAL_BITS"
+
+// ---------------------------------------------------------------------------
+/** @brief Encoding of binary buffers.
+ *
+ * "none" writes plain data. "filter" delta-encodes index and vertex
+ * streams into a form which compresses much better, for use with a
+ * compressing transport (i.e. HTTP gzip). "deflate" additionally zlib
+ * compresses each bufferView. Filtered bufferViews carry the
+ * ASSIMP2GLTF_buffer_compression extension, see Readme.md for the
+ * decoding steps.
+ * Has no effect unless the vertex data goes to binary buffers.
+ * Property type: String. Default value: "none".
+ */
+#define AI_CONFIG_EXPORT_GLTF_COMPRESSION "EXPORT_GLTF_COMPRESSION"
+
+// ---------------------------------------------------------------------------
+/** @brief Keep large meshes in one piece and index them with 32 bit
+ *  indices.
+ *
+ * By default meshes with more than 65536 vertices are split so that every
+ * index fits into an UNSIGNED_SHORT, as WebGL 1.0 requires. Clients which
+ * support OES_element_index_uint (or WebGL 2.0) can take UNSIGNED_INT
+ * indices instead, which avoids the split and the vertices it duplicates.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_UINT32_INDICES "EXPORT_GLTF_UINT32_INDICES"
+
+// ---------------------------------------------------------------------------
+/** @brief How meshes exceeding the 16 bit index range are split.
+ *
+ * "order" fills each piece with faces in their original order. "spatial"
+ * takes faces in Morton order of their centroids instead, which gives
+ * compact pieces with tighter bounds and fewer vertices duplicated along
+ * the seams. Either way, each piece is written with its own bounds.
+ * Property type: String. Default value: "order".
+ */
+#define AI_CONFIG_EXPORT_GLTF_SPLIT_MODE "EXPORT_GLTF_SPLIT_MODE"
+
+// ---------------------------------------------------------------------------
+/** @brief Write identical meshes, materials and embedded textures once.
+ *
+ * Items are compared by content, their names are ignored. Nodes refer
+ * to the unique copy of each mesh, meshes to the unique copy of their
+ * material and materials to the unique copy of their textures. Meshes
+ * with animation meshes are never merged.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_DEDUPLICATE "EXPORT_GLTF_DEDUPLICATE"
+
+// ---------------------------------------------------------------------------
+/** @brief Levels of detail to write for each mesh.
+ *
+ * A comma separated list of decreasing face ratios in (0,1), relative to
+ * the full mesh, i.e. "0.5,0.25,0.125". Each level is simplified from the
+ * one before by edge collapses (see aiProcess_SimplifyMeshes) and written
+ * as a mesh of its own after all other meshes. The full mesh lists its
+ * levels under "lods", each with the index of its mesh and its "error":
+ * an estimate of the deviation of the simplified surface from the full
+ * one, in the units of the mesh's positions. A chain ends early
+ * once a mesh can't be simplified any further.
+ * Property type: String. Default value: "" (no levels of detail).
+ */
+#define AI_CONFIG_EXPORT_GLTF_LODS "EXPORT_GLTF_LODS"
+
+// ---------------------------------------------------------------------------
+/** @brief Write the cluster tables of each mesh.
+ *
+ * Clusters are runs of consecutive triangles as arranged by the
+ * aiProcess_GenMeshlets step, found again with the limits given by
+ * AI_CONFIG_PP_GM_MAX_VERTICES and AI_CONFIG_PP_GM_MAX_TRIANGLES,
+ * which must be the ones the step ran with. Each mesh gets a "meshlets"
+ * object of three flat arrays: "triangles" with the first triangle and
+ * the number of triangles of each cluster, "spheres" with the center and
+ * radius of its bounding sphere and "cones" with the axis and cutoff of
+ * its normal cone (see Assimp::Meshlet).
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_EXPORT_GLTF_MESHLETS "EXPORT_GLTF_MESHLETS"
+
+#endif // INCLUDED_GLTF_CONFIG
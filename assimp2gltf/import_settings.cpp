@@ -0,0 +1,217 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "import_settings.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <sstream>
+
+const unsigned int kPostProcessing = aiProcessPreset_TargetRealtime_MaxQuality;
+
+const int kMeshletMaxVertices = AI_GM_DEFAULT_MAX_VERTICES;
+const int kMeshletMaxTriangles = AI_GM_DEFAULT_MAX_TRIANGLES;
+
+namespace {
+
+const struct {
+	unsigned int flag;
+	const char* name;
+} kSteps[] = {
+	{ aiProcess_CalcTangentSpace,         "CalcTangentSpace" },
+	{ aiProcess_JoinIdenticalVertices,    "JoinIdenticalVertices" },
+	{ aiProcess_MakeLeftHanded,           "MakeLeftHanded" },
+	{ aiProcess_Triangulate,              "Triangulate" },
+	{ aiProcess_RemoveComponent,          "RemoveComponent" },
+	{ aiProcess_GenNormals,               "GenNormals" },
+	{ aiProcess_GenSmoothNormals,         "GenSmoothNormals" },
+	{ aiProcess_SplitLargeMeshes,         "SplitLargeMeshes" },
+	{ aiProcess_PreTransformVertices,     "PreTransformVertices" },
+	{ aiProcess_LimitBoneWeights,         "LimitBoneWeights" },
+	{ aiProcess_ValidateDataStructure,    "ValidateDataStructure" },
+	{ aiProcess_ImproveCacheLocality,     "ImproveCacheLocality" },
+	{ aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials" },
+	{ aiProcess_FixInfacingNormals,       "FixInfacingNormals" },
+	{ aiProcess_SortByPType,              "SortByPType" },
+	{ aiProcess_FindDegenerates,          "FindDegenerates" },
+	{ aiProcess_FindInvalidData,          "FindInvalidData" },
+	{ aiProcess_GenUVCoords,              "GenUVCoords" },
+	{ aiProcess_TransformUVCoords,        "TransformUVCoords" },
+	{ aiProcess_FindInstances,            "FindInstances" },
+	{ aiProcess_OptimizeMeshes,           "OptimizeMeshes" },
+	{ aiProcess_OptimizeGraph,            "OptimizeGraph" },
+	{ aiProcess_FlipUVs,                  "FlipUVs" },
+	{ aiProcess_FlipWindingOrder,         "FlipWindingOrder" },
+	{ aiProcess_SplitByBoneCount,         "SplitByBoneCount" },
+	{ aiProcess_Debone,                   "Debone" },
+	{ aiProcess_SimplifyMeshes,           "SimplifyMeshes" },
+	{ aiProcess_GenMeshlets,              "GenMeshlets" },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Get the steps which can't run along with flag, see Importer::_ValidateFlags()
+unsigned int GetExclusiveSteps(unsigned int flag)
+{
+	switch (flag) {
+	case aiProcess_GenNormals:
+		return aiProcess_GenSmoothNormals;
+	case aiProcess_GenSmoothNormals:
+		return aiProcess_GenNormals;
+	case aiProcess_OptimizeGraph:
+		return aiProcess_PreTransformVertices;
+	case aiProcess_PreTransformVertices:
+		return aiProcess_OptimizeGraph;
+	}
+	return 0;
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+bool SetPostProcessingProfile(PostProcessing& pp, const std::string& name)
+{
+	pp.adaptive = false;
+	if (name == "fast") {
+		pp.flags = aiProcessPreset_TargetRealtime_Fast;
+	}
+	else if (name == "balanced") {
+		pp.flags = aiProcessPreset_TargetRealtime_Quality;
+	}
+	else if (name == "max") {
+		pp.flags = aiProcessPreset_TargetRealtime_MaxQuality;
+	}
+	else if (name == "auto") {
+		pp.flags = aiProcessPreset_TargetRealtime_MaxQuality;
+		pp.adaptive = true;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool TogglePostProcessingSteps(PostProcessing& pp, const std::string& list)
+{
+	unsigned int flags = pp.flags;
+
+	std::istringstream ss(list);
+	for (std::string item; std::getline(ss, item, ','); ) {
+		if (item.size() < 2 || (item[0] != '+' && item[0] != '-')) {
+			return false;
+		}
+
+		unsigned int flag = 0;
+		for (size_t i = 0; i < sizeof(kSteps) / sizeof(kSteps[0]); ++i) {
+			if (item.compare(1, std::string::npos, kSteps[i].name) == 0) {
+				flag = kSteps[i].flag;
+				break;
+			}
+		}
+		if (!flag) {
+			return false;
+		}
+
+		if (item[0] == '+') {
+			flags = (flags & ~GetExclusiveSteps(flag)) | flag;
+		}
+		else {
+			flags &= ~flag;
+		}
+	}
+
+	pp.flags = flags;
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int GetRedundantSteps(const aiScene& scene, unsigned int flags)
+{
+	bool all_normals = true, all_tangents = true, only_triangles = true, sorted = true, bones = false;
+	for (unsigned int i = 0; i < scene.mNumMeshes; ++i) {
+		const aiMesh* const mesh = scene.mMeshes[i];
+
+		all_normals = all_normals && mesh->HasNormals();
+		// CalcTangentSpace leaves meshes without texture coordinates alone
+		all_tangents = all_tangents && (mesh->HasTangentsAndBitangents() || !mesh->HasTextureCoords(0));
+		only_triangles = only_triangles && mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+		// SortByPType splits meshes with mixed primitives and drops points and lines
+		const unsigned int types = mesh->mPrimitiveTypes;
+		sorted = sorted && !(types & (types - 1)) && !(types & (aiPrimitiveType_POINT | aiPrimitiveType_LINE));
+		bones = bones || mesh->HasBones();
+	}
+
+	unsigned int redundant = 0;
+	// generated normals would also be missing tangents
+	if (all_normals) {
+		redundant |= aiProcess_GenNormals | aiProcess_GenSmoothNormals;
+		if (all_tangents) {
+			redundant |= aiProcess_CalcTangentSpace;
+		}
+	}
+	if (only_triangles) {
+		redundant |= aiProcess_Triangulate;
+	}
+	if (sorted) {
+		redundant |= aiProcess_SortByPType;
+	}
+	if (!bones) {
+		redundant |= aiProcess_LimitBoneWeights | aiProcess_SplitByBoneCount | aiProcess_Debone;
+	}
+	if (scene.mNumMeshes < 2) {
+		redundant |= aiProcess_FindInstances | aiProcess_OptimizeMeshes;
+	}
+	if (scene.mNumMaterials < 2) {
+		redundant |= aiProcess_RemoveRedundantMaterials;
+	}
+	return flags & redundant;
+}
+
+// ------------------------------------------------------------------------------------------------
+const aiScene* ReadScene(Assimp::Importer& imp, const std::string& file, const PostProcessing& pp)
+{
+	imp.SetPropertyBool(AI_CONFIG_PP_JV_EXACT, pp.exact_weld);
+
+	if (!pp.adaptive) {
+		return imp.ReadFile(file, pp.flags);
+	}
+
+	// import without post processing to see what the scene is missing, only
+	// validate it right away as the inspection relies on it being sane
+	const aiScene* const scene = imp.ReadFile(file, pp.flags & aiProcess_ValidateDataStructure);
+	if (!scene) {
+		return NULL;
+	}
+
+	const unsigned int flags = pp.flags & ~aiProcess_ValidateDataStructure;
+	return imp.ApplyPostProcessing(flags & ~GetRedundantSteps(*scene, flags));
+}
+
+// ------------------------------------------------------------------------------------------------
+void SetupImporter(Assimp::Importer& imp, bool measure, int threads)
+{
+	imp.SetPropertyBool(AI_CONFIG_GLOB_MEASURE_TIME, measure);
+	imp.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, threads);
+
+	// instruct aiProcess_FindDegenerates to drop degenerates 
+	imp.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
+	// instruct aiProcess_SortByPrimitiveType to drop line and point meshes
+	imp.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+
+	// instruct aiProcess_GenSmoothNormals to not smooth normals with an angle of more than 70deg
+	imp.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 70.0f);
+	// instruct aiProcess_CalcTangents to not smooth normals with an angle of more than 70deg
+	imp.SetPropertyFloat(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, 70.0f);
+
+	// cluster limits of aiProcess_GenMeshlets, the exporter needs the same ones
+	imp.SetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES, kMeshletMaxVertices);
+	imp.SetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES, kMeshletMaxTriangles);
+}
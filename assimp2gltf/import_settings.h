@@ -0,0 +1,81 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_IMPORT_SETTINGS
+#define INCLUDED_IMPORT_SETTINGS
+
+#include <string>
+
+struct aiScene;
+namespace Assimp {
+	class Importer;
+}
+
+/** Post processing steps run on every imported scene unless configured otherwise,
+ *  same as the "max" profile */
+extern const unsigned int kPostProcessing;
+
+/** Cluster limits of the GenMeshlets step. The exporter finds the clusters again
+ *  from the face order, so its properties must be set to the same values, see
+ *  AI_CONFIG_EXPORT_GLTF_MESHLETS */
+extern const int kMeshletMaxVertices;
+extern const int kMeshletMaxTriangles;
+
+// ------------------------------------------------------------------------------------------------
+/** Post processing to run on imported scenes */
+struct PostProcessing
+{
+	PostProcessing()
+		: flags(kPostProcessing)
+		, adaptive(false)
+		, exact_weld(false)
+	{}
+
+	/** aiPostProcessSteps to run */
+	unsigned int flags;
+
+	/** Skip those of flags whose results the imported scene already has,
+	 *  see GetRedundantSteps() */
+	bool adaptive;
+
+	/** Let JoinIdenticalVertices join only bit-identical vertices,
+	 *  see AI_CONFIG_PP_JV_EXACT */
+	bool exact_weld;
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Select a post processing profile by name: "fast", "balanced" and "max" map to
+ *  aiProcessPreset_TargetRealtime_Fast, _Quality and _MaxQuality, "auto" is "max"
+ *  with adaptive set. Returns false for unknown names. */
+bool SetPostProcessingProfile(PostProcessing& pp, const std::string& name);
+
+// ------------------------------------------------------------------------------------------------
+/** Turn single steps on or off, given as a comma separated list of step names
+ *  (the names of aiProcess_XXX without prefix), each prefixed with + or -.
+ *  Returns false and leaves pp untouched if the list is malformed. */
+bool TogglePostProcessingSteps(PostProcessing& pp, const std::string& list);
+
+// ------------------------------------------------------------------------------------------------
+/** Get the steps out of flags which would not change the scene, as it already
+ *  has normals, tangents, only triangles, ... */
+unsigned int GetRedundantSteps(const aiScene& scene, unsigned int flags);
+
+// ------------------------------------------------------------------------------------------------
+/** Import a file with the given post processing. Returns NULL on failure, with
+ *  the reason in imp.GetErrorString() */
+const aiScene* ReadScene(Assimp::Importer& imp, const std::string& file, const PostProcessing& pp);
+
+// ------------------------------------------------------------------------------------------------
+/** Set the importer properties used for all conversions.
+ *  @param measure Take measurements of the import, see Importer::GetProfile()
+ *  @param threads Number of threads for post processing, 0 for one per hardware thread
+ */
+void SetupImporter(Assimp::Importer& imp, bool measure, int threads);
+
+#endif // INCLUDED_IMPORT_SETTINGS
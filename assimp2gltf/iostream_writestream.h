@@ -0,0 +1,113 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_IOSTREAM_WRITESTREAM
+#define INCLUDED_IOSTREAM_WRITESTREAM
+
+#include <assimp/IOStream.hpp>
+#include <assimp/../../code/Exceptional.h>
+
+#include "rapidjson/rapidjson.h"
+
+#include <algorithm>
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+/** rapidjson output stream writing to an Assimp::IOStream.
+ *
+ *  Output is collected in a fixed-size buffer which is handed to the
+ *  IOStream whenever it runs full, so memory usage does not depend on
+ *  the size of the document and data reaches the target as soon as the
+ *  first buffer is complete. Modeled after rapidjson::FileWriteStream.
+ */
+class IOStreamWriteStream
+{
+public:
+
+	typedef char Ch;
+
+	static const size_t BUFFER_SIZE = 64 * 1024;
+
+public:
+
+	explicit IOStreamWriteStream(Assimp::IOStream& stream)
+		: stream(stream)
+		, current(buffer)
+	{
+	}
+
+	~IOStreamWriteStream() {
+		try {
+			Flush();
+		}
+		catch (...) {
+			// can't report errors here, call Flush() before going out of scope
+		}
+	}
+
+public:
+
+	void Put(char c) {
+		if (current == buffer + BUFFER_SIZE) {
+			Flush();
+		}
+		*current++ = c;
+	}
+
+	void PutN(char c, size_t n) {
+		while (n) {
+			if (current == buffer + BUFFER_SIZE) {
+				Flush();
+			}
+
+			const size_t chunk = std::min(n, static_cast<size_t>(buffer + BUFFER_SIZE - current));
+			::memset(current, c, chunk);
+			current += chunk;
+			n -= chunk;
+		}
+	}
+
+	void Flush() {
+		const size_t size = static_cast<size_t>(current - buffer);
+		current = buffer;
+		if (size && stream.Write(buffer, 1, size) != size) {
+			throw DeadlyExportError("failed to write JSON output");
+		}
+	}
+
+	// Not implemented
+	char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
+	char Take() { RAPIDJSON_ASSERT(false); return 0; }
+	size_t Tell() const { RAPIDJSON_ASSERT(false); return 0; }
+	char* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+	size_t PutEnd(char*) { RAPIDJSON_ASSERT(false); return 0; }
+
+private:
+
+	// Prohibit copy constructor & assignment operator.
+	IOStreamWriteStream(const IOStreamWriteStream&);
+	IOStreamWriteStream& operator=(const IOStreamWriteStream&);
+
+	Assimp::IOStream& stream;
+
+	char buffer[BUFFER_SIZE];
+	char* current;
+};
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! Implement specialized version of PutN() with memset() for better performance.
+template<>
+inline void PutN(IOStreamWriteStream& stream, char c, size_t n) {
+	stream.PutN(c, n);
+}
+
+RAPIDJSON_NAMESPACE_END
+
+#endif // INCLUDED_IOSTREAM_WRITESTREAM
@@ -13,10 +13,16 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 #include <assimp/IOSystem.hpp>
 
 #include <assimp/scene.h>
+#include <assimp/config.h>
 
 #include <sstream>
+#include <vector>
+#include <algorithm>
 #include <limits>
+#include <stdint.h>
 #include <cassert>
+#include <cctype>
+#include <cstring>
 
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/prettywriter.h"
@@ -26,8 +32,20 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 
 // grab scoped_ptr from assimp to avoid a dependency on boost. 
 #include <assimp/../../code/BoostWorkaround/boost/scoped_ptr.hpp>
+#include <assimp/../../code/Exceptional.h>
+#include <assimp/../../code/Profiler.h>
+#include <assimp/../../code/GenMeshlets.h>
+#include <assimp/../../code/WorkerPool.h>
 
 #include "mesh_splitter.h"
+#include "deduplicator.h"
+#include "lod_builder.h"
+#include "scene_bounds.h"
+#include "buffer_builder.h"
+#include "png_encoder.h"
+#include "iostream_writestream.h"
+#include "json_writer.h"
+#include "gltf_config.h"
 
 
 extern "C" {
@@ -36,6 +54,17 @@ extern "C" {
 
 namespace {
 void assimp2gltf(const char*, Assimp::IOSystem*, const aiScene*, const Assimp::ExportProperties*);
+void assimp2glb(const char*, Assimp::IOSystem*, const aiScene*, const Assimp::ExportProperties*);
+
+// Receives the measurements of exports on this thread, see SetExportProfile()
+thread_local Assimp::ProfileRegionList* export_profile = NULL;
+}
+
+// Measure the sections of all following exports on the calling thread and append the results
+// to profile. Pass NULL to stop measuring.
+void SetExportProfile(Assimp::ProfileRegionList* profile)
+{
+	export_profile = profile;
 }
 
 Assimp::Exporter::ExportFormatEntry assimp2gltf_desc = Assimp::Exporter::ExportFormatEntry(
@@ -45,50 +74,112 @@ Assimp::Exporter::ExportFormatEntry assimp2gltf_desc = Assimp::Exporter::ExportF
 	assimp2gltf,
 	0u);
 
+Assimp::Exporter::ExportFormatEntry assimp2glb_desc = Assimp::Exporter::ExportFormatEntry(
+	"assimp.glb",
+	"Binary container (JSON chunk + binary chunk, GLB layout) of the Assimp scene data structure",
+	"glb",
+	assimp2glb,
+	0u);
+
 namespace {
 
 using namespace rapidjson;
 
-void Write(PrettyWriter<StringBuffer>& out, const aiVector3D& ai) 
+// State shared by the writers during one export
+struct ExportContext
+{
+	const SplitMeshList* meshes;
+	const UniqueContent* content;
+
+	// levels of detail of the unique meshes
+	const LodList* lods;
+
+	// bounds of each entry of the meshes array and of the nodes
+	const SceneBounds* bounds;
+
+	// clusters of each entry of the meshes array, NULL unless enabled
+	const std::vector< std::vector<Assimp::Meshlet> >* meshlets;
+
+	// NULL unless vertex data goes to binary buffers
+	BufferBuilder* buffers;
+	std::string buffer_uri;
+
+	Assimp::WorkerPool* pool;
+
+	// NULL unless measuring, see SetExportProfile()
+	Assimp::Profiling::Profiler* profiler;
+};
+
+// Get the total number of vertices and faces in a list of meshes
+void CountMeshes(const std::vector<const aiMesh*>& meshes, unsigned int& vertices, unsigned int& faces)
+{
+	vertices = faces = 0;
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		vertices += meshes[i]->mNumVertices;
+		faces += meshes[i]->mNumFaces;
+	}
+}
+
+template <typename Writer>
+void Write(Writer& out, const aiVector3D& ai) 
 {
 	out.StartArray();
-    out.Double(ai.x);
-    out.Double(ai.y);
-    out.Double(ai.z);
+    out.Float(ai.x);
+    out.Float(ai.y);
+    out.Float(ai.z);
 	out.EndArray();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiQuaternion& ai) 
+template <typename Writer>
+void Write(Writer& out, const aiQuaternion& ai) 
 {
 	out.StartArray();
-    out.Double(ai.w);
-    out.Double(ai.x);
-    out.Double(ai.y);
-    out.Double(ai.z);
+    out.Float(ai.w);
+    out.Float(ai.x);
+    out.Float(ai.y);
+    out.Float(ai.z);
 	out.EndArray();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiColor3D& ai) 
+template <typename Writer>
+void Write(Writer& out, const aiColor3D& ai) 
 {
 	out.StartArray();
-    out.Double(ai.r);
-    out.Double(ai.g);
-    out.Double(ai.b);
+    out.Float(ai.r);
+    out.Float(ai.g);
+    out.Float(ai.b);
 	out.EndArray();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiMatrix4x4& ai) 
+template <typename Writer>
+void Write(Writer& out, const aiMatrix4x4& ai) 
 {
 	out.StartArray();
 	for(unsigned int x = 0; x < 4; ++x) {
 		for(unsigned int y = 0; y < 4; ++y) {
-			out.Double(ai[x][y]);
+			out.Float(ai[x][y]);
 		}
 	}
 	out.EndArray();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiBone& ai)
+template <typename Writer>
+void Write(Writer& out, const Bounds& ai)
+{
+	out.StartObject();
+	out.Key("min");
+	Write(out,ai.min);
+	out.Key("max");
+	Write(out,ai.max);
+	out.Key("center");
+	Write(out,ai.center);
+	out.Key("radius");
+	out.Float(ai.radius);
+	out.EndObject();
+}
+
+template <typename Writer>
+void Write(Writer& out, const aiBone& ai)
 {
 	out.StartObject();
 
@@ -103,7 +194,7 @@ void Write(PrettyWriter<StringBuffer>& out, const aiBone& ai)
 	for(unsigned int i = 0; i < ai.mNumWeights; ++i) {
 		out.StartArray();
 		out.Uint(ai.mWeights[i].mVertexId);
-		out.Double(ai.mWeights[i].mWeight);
+		out.Float(ai.mWeights[i].mWeight);
 		out.EndArray();
 	}
 	out.EndArray();
@@ -111,7 +202,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiBone& ai)
 }
 
 
-void Write(PrettyWriter<StringBuffer>& out, const aiFace& ai)
+template <typename Writer>
+void Write(Writer& out, const aiFace& ai)
 {
 	out.StartArray();
 	for(unsigned int i = 0; i < ai.mNumIndices; ++i) {
@@ -121,7 +213,10 @@ void Write(PrettyWriter<StringBuffer>& out, const aiFace& ai)
 }
 
 
-void Write(PrettyWriter<StringBuffer>& out, const aiMesh& ai)
+template <typename Writer>
+void Write(Writer& out, const aiMesh& ai, unsigned int material, const BufferBuilder::MeshAccessors* accessors,
+	const Bounds& bounds, const std::vector<LodLevel>* lods, unsigned int first_lod,
+	const std::vector<Assimp::Meshlet>* meshlets)
 {
 	out.StartObject(); 
 
@@ -129,47 +224,118 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMesh& ai)
 	out.String(ai.mName.C_Str());
 
 	out.Key("materialindex");
-	out.Uint(ai.mMaterialIndex);
+	out.Uint(material);
 
 	out.Key("primitivetypes");
     out.Uint(ai.mPrimitiveTypes);
 
+	out.Key("bounds");
+	Write(out,bounds);
+
+	// simplified versions of the mesh, written after all other meshes
+	if(lods && !lods->empty()) {
+		out.Key("lods");
+		out.StartArray();
+		for(size_t i = 0; i < lods->size(); ++i) {
+			out.StartObject();
+			out.Key("mesh");
+			out.Uint(first_lod + (*lods)[i].mesh);
+			out.Key("error");
+			out.Float((*lods)[i].error);
+			out.EndObject();
+		}
+		out.EndArray();
+	}
+
+	// clusters as flat tables: a range of triangles in the index stream, then
+	// the bounding sphere and the normal cone of each cluster
+	if(meshlets && !meshlets->empty()) {
+		out.Key("meshlets");
+		out.StartObject();
+		out.Key("triangles");
+		out.StartArray();
+		for(size_t i = 0; i < meshlets->size(); ++i) {
+			out.Uint((*meshlets)[i].mFirstFace);
+			out.Uint((*meshlets)[i].mNumFaces);
+		}
+		out.EndArray();
+		out.Key("spheres");
+		out.StartArray();
+		for(size_t i = 0; i < meshlets->size(); ++i) {
+			const Assimp::Meshlet& m = (*meshlets)[i];
+			out.Float(m.mCenter.x);
+			out.Float(m.mCenter.y);
+			out.Float(m.mCenter.z);
+			out.Float(m.mRadius);
+		}
+		out.EndArray();
+		out.Key("cones");
+		out.StartArray();
+		for(size_t i = 0; i < meshlets->size(); ++i) {
+			const Assimp::Meshlet& m = (*meshlets)[i];
+			out.Float(m.mConeAxis.x);
+			out.Float(m.mConeAxis.y);
+			out.Float(m.mConeAxis.z);
+			out.Float(m.mConeCutoff);
+		}
+		out.EndArray();
+		out.EndObject();
+	}
+
+	// with binary buffers, streams are written as references to accessors
+	// instead and their data goes to the payload.
 	out.Key("vertices");
-	out.StartArray();
-	for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
-		out.Double(ai.mVertices[i].x);
-        out.Double(ai.mVertices[i].y);
-        out.Double(ai.mVertices[i].z);
+	if(accessors) {
+		out.Uint(accessors->positions);
+	}
+	else {
+		out.StartArray();
+		for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
+			out.Float(ai.mVertices[i].x);
+			out.Float(ai.mVertices[i].y);
+			out.Float(ai.mVertices[i].z);
+		}
+		out.EndArray();
 	}
-	out.EndArray();
 
-	if(ai.HasNormals()) {
+	if(ai.HasNormals() && accessors) {
+		out.Key("normals");
+		out.Uint(accessors->normals);
+	}
+	else if(ai.HasNormals()) {
 		out.Key("normals");
 		out.StartArray();
 		for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Double(ai.mNormals[i].x);
-            out.Double(ai.mNormals[i].y);
-            out.Double(ai.mNormals[i].z);
+            out.Float(ai.mNormals[i].x);
+            out.Float(ai.mNormals[i].y);
+            out.Float(ai.mNormals[i].z);
 		}
 		out.EndArray();
 	}
 
-	if(ai.HasTangentsAndBitangents()) {
+	if(ai.HasTangentsAndBitangents() && accessors) {
+		out.Key("tangents");
+		out.Uint(accessors->tangents);
+
+		out.Key("bitangents");
+		out.Uint(accessors->bitangents);
+	}
+	else if(ai.HasTangentsAndBitangents()) {
 		out.Key("tangents");
 		out.StartArray();
 		for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Double(ai.mTangents[i].x);
-            out.Double(ai.mTangents[i].y);
-            out.Double(ai.mTangents[i].z);
+            out.Float(ai.mTangents[i].x);
+            out.Float(ai.mTangents[i].y);
+            out.Float(ai.mTangents[i].z);
 		}
 		out.EndArray();
 
 		out.Key("bitangents");
 		out.StartArray();
 		for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Double(ai.mBitangents[i].x);
-            out.Double(ai.mBitangents[i].y);
-            out.Double(ai.mBitangents[i].z);
+            out.Float(ai.mBitangents[i].x);
+            out.Float(ai.mBitangents[i].y);
+            out.Float(ai.mBitangents[i].z);
 		}
 		out.EndArray();
 	}
@@ -186,12 +352,17 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMesh& ai)
 		out.StartArray();
 		for(unsigned int n = 0; n < ai.GetNumUVChannels(); ++n) {
 
+			if(accessors) {
+				out.Uint(accessors->texturecoords[n]);
+				continue;
+			}
+
 			const unsigned int numc = ai.mNumUVComponents[n] ? ai.mNumUVComponents[n] : 2;
 			
 			out.StartArray();
 			for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
 				for(unsigned int c = 0; c < numc; ++c) {
-					out.Double(ai.mTextureCoords[n][i][c]);
+					out.Float(ai.mTextureCoords[n][i][c]);
 				}
 			}
 			out.EndArray();
@@ -204,12 +375,17 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMesh& ai)
 		out.StartArray();
 		for(unsigned int n = 0; n < ai.GetNumColorChannels(); ++n) {
 
+			if(accessors) {
+				out.Uint(accessors->colors[n]);
+				continue;
+			}
+
 			out.StartArray();
 			for(unsigned int i = 0; i < ai.mNumVertices; ++i) {
-				out.Double(ai.mColors[n][i].r);
-                out.Double(ai.mColors[n][i].g);
-                out.Double(ai.mColors[n][i].b);
-                out.Double(ai.mColors[n][i].a);
+				out.Float(ai.mColors[n][i].r);
+                out.Float(ai.mColors[n][i].g);
+                out.Float(ai.mColors[n][i].b);
+                out.Float(ai.mColors[n][i].a);
 			}
 			out.EndArray();
 		}
@@ -226,18 +402,28 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMesh& ai)
 	}
 
 
-	out.Key("faces");
-	out.StartArray();
-	for(unsigned int n = 0; n < ai.mNumFaces; ++n) {
-		Write(out, ai.mFaces[n]);
+	// meshes with mixed face types can't be expressed as a flat index
+	// stream, so they keep the per-face representation.
+	if(accessors && accessors->indices != BufferBuilder::NO_ACCESSOR) {
+		out.Key("indices");
+		out.Uint(accessors->indices);
+	}
+	else {
+		out.Key("faces");
+		out.StartArray();
+		for(unsigned int n = 0; n < ai.mNumFaces; ++n) {
+			Write(out, ai.mFaces[n]);
+		}
+		out.EndArray();
 	}
-	out.EndArray();
 
 	out.EndObject();
 }
 
 
-void Write(PrettyWriter<StringBuffer>& out, const aiNode& ai)
+template <typename Writer>
+void Write(Writer& out, const aiNode& ai, const SplitMeshList& meshes, const UniqueContent& content,
+	const SceneBounds& bounds)
 {
 	out.StartObject();
 
@@ -247,11 +433,24 @@ void Write(PrettyWriter<StringBuffer>& out, const aiNode& ai)
 	out.Key("transformation");
 	Write(out,ai.mTransformation);
 
+	// everything below the node, before its own transformation
+	const Bounds* const node_bounds = bounds.GetNode(&ai);
+	if(node_bounds) {
+		out.Key("extras");
+		out.StartObject();
+		out.Key("bounds");
+		Write(out,*node_bounds);
+		out.EndObject();
+	}
+
 	if(ai.mNumMeshes) {
 		out.Key("meshes");
 		out.StartArray();
 		for(unsigned int n = 0; n < ai.mNumMeshes; ++n) {
-			out.Uint(ai.mMeshes[n]);
+			// a mesh which has been split is referenced by all of its submeshes
+			for(unsigned int i = 0; i < meshes.GetCount(ai.mMeshes[n]); ++i) {
+				out.Uint(content.GetMesh(meshes.GetFirst(ai.mMeshes[n]) + i));
+			}
 		}
 		out.EndArray();
 	}
@@ -260,7 +459,7 @@ void Write(PrettyWriter<StringBuffer>& out, const aiNode& ai)
 		out.Key("children");
 		out.StartArray();
 		for(unsigned int n = 0; n < ai.mNumChildren; ++n) {
-			Write(out,*ai.mChildren[n]);
+			Write(out,*ai.mChildren[n],meshes,content,bounds);
 		}
 		out.EndArray();
 	}
@@ -268,7 +467,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiNode& ai)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiMaterial& ai)
+template <typename Writer>
+void Write(Writer& out, const aiMaterial& ai, const UniqueContent& content)
 {
 	out.StartObject();
 
@@ -294,12 +494,12 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMaterial& ai)
 			if(prop->mDataLength/sizeof(float) > 1) {
 				out.StartArray();
 				for(unsigned int i = 0; i < prop->mDataLength/sizeof(float); ++i) {
-					out.Double(reinterpret_cast<float*>(prop->mData)[i]);
+					out.Float(reinterpret_cast<float*>(prop->mData)[i]);
 				}
 				out.EndArray();
 			}
 			else {
-                out.Double(*reinterpret_cast<float*>(prop->mData));
+                out.Float(*reinterpret_cast<float*>(prop->mData));
 			}
 			break;
 
@@ -319,7 +519,15 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMaterial& ai)
 			{
 				aiString s;
 				aiGetMaterialString(&ai,prop->mKey.data,prop->mSemantic,prop->mIndex,&s);
-				out.String(s.C_Str());
+
+				// references to embedded textures follow them to their unique copy
+				if(!strcmp(prop->mKey.C_Str(),_AI_MATKEY_TEXTURE_BASE)) {
+					const std::string file = content.GetTextureFile(s.C_Str());
+					out.String(file.c_str(),static_cast<SizeType>(file.size()));
+				}
+				else {
+					out.String(s.C_Str());
+				}
 			}
 			break;
 		case aiPTI_Buffer:
@@ -339,7 +547,37 @@ void Write(PrettyWriter<StringBuffer>& out, const aiMaterial& ai)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiTexture& ai)
+// Encoded image of an embedded texture
+struct TextureImage
+{
+	const unsigned char* data;
+	size_t size;
+	std::string mimeType;
+
+	// NO_ACCESSOR unless the image lives in the binary buffer
+	unsigned int bufferView;
+};
+
+// Guess the MIME type of a compressed embedded texture from its format hint
+std::string GetImageMimeType(const aiTexture& ai)
+{
+	std::string hint = aiString(ai.achFormatHint).C_Str();
+	std::transform(hint.begin(), hint.end(), hint.begin(), ::tolower);
+
+	if(hint == "jpg" || hint == "jpeg") {
+		return "image/jpeg";
+	}
+	if(hint == "png" || hint == "gif" || hint == "bmp" || hint == "tiff") {
+		return "image/" + hint;
+	}
+	if(hint == "dds") {
+		return "image/vnd.ms-dds";
+	}
+	return "application/octet-stream";
+}
+
+template <typename Writer>
+void Write(Writer& out, const aiTexture& ai, const TextureImage& image)
 {
 	out.StartObject();
 
@@ -352,32 +590,40 @@ void Write(PrettyWriter<StringBuffer>& out, const aiTexture& ai)
 	out.Key("formathint");
 	out.String(aiString(ai.achFormatHint).C_Str());
 
-	out.Key("data");
-	if(!ai.mHeight) {
-		out.String((char*)ai.pcData,ai.mWidth);
+	out.Key("mimeType");
+	out.String(image.mimeType.c_str());
+
+	// the image goes to the binary buffer or inline as data uri
+	if(image.bufferView != BufferBuilder::NO_ACCESSOR) {
+		out.Key("bufferView");
+		out.Uint(image.bufferView);
 	}
 	else {
-		out.StartArray();
-		for(unsigned int y = 0; y < ai.mHeight; ++y) {
-			out.StartArray();
-			for(unsigned int x = 0; x < ai.mWidth; ++x) {
-				const aiTexel& tx = ai.pcData[y*ai.mWidth+x];
-				out.StartArray();
-				out.Uint(static_cast<unsigned int>(tx.r));
-                out.Uint(static_cast<unsigned int>(tx.g));
-                out.Uint(static_cast<unsigned int>(tx.b));
-                out.Uint(static_cast<unsigned int>(tx.a));
-				out.EndArray();
-			}
-			out.EndArray();
-		}
-		out.EndArray();
+		const std::string prefix = "data:" + image.mimeType + ";base64,";
+
+		std::string uri(prefix.size() + image.size * 2 + 8, '\0');
+		std::copy(prefix.begin(), prefix.end(), uri.begin());
+
+		base64_encodestate state;
+		base64_init_encodestate(&state);
+
+		char* const start = &uri[prefix.size()];
+		char* end = start + base64_encode_block(reinterpret_cast<const char*>(image.data), static_cast<int>(image.size), start, &state);
+		end += base64_encode_blockend(end, &state);
+
+		// the encoder breaks lines, which has no place in a uri
+		end = std::remove(start, end, '\n');
+		uri.resize(end - &uri[0]);
+
+		out.Key("uri");
+		out.String(uri.c_str(), static_cast<SizeType>(uri.size()));
 	}
 
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiLight& ai)
+template <typename Writer>
+void Write(Writer& out, const aiLight& ai)
 {
 	out.StartObject();
 
@@ -389,20 +635,20 @@ void Write(PrettyWriter<StringBuffer>& out, const aiLight& ai)
 
 	if(ai.mType == aiLightSource_SPOT || ai.mType == aiLightSource_UNDEFINED) {
 		out.Key("angleinnercone");
-		out.Double(ai.mAngleInnerCone);
+		out.Float(ai.mAngleInnerCone);
 
 		out.Key("angleoutercone");
-        out.Double(ai.mAngleOuterCone);
+        out.Float(ai.mAngleOuterCone);
 	}
 
 	out.Key("attenuationconstant");
-    out.Double(ai.mAttenuationConstant);
+    out.Float(ai.mAttenuationConstant);
 
 	out.Key("attenuationlinear");
-    out.Double(ai.mAttenuationLinear);
+    out.Float(ai.mAttenuationLinear);
 
 	out.Key("attenuationquadratic");
-    out.Double(ai.mAttenuationQuadratic);
+    out.Float(ai.mAttenuationQuadratic);
 
 	out.Key("diffusecolor");
 	Write(out,ai.mColorDiffuse);
@@ -427,7 +673,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiLight& ai)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiNodeAnim& ai)
+template <typename Writer>
+void Write(Writer& out, const aiNodeAnim& ai)
 {
 	out.StartObject();
 
@@ -481,7 +728,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiNodeAnim& ai)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiAnimation& ai)
+template <typename Writer>
+void Write(Writer& out, const aiAnimation& ai)
 {
 	out.StartObject();
 
@@ -503,7 +751,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiAnimation& ai)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiCamera& ai)
+template <typename Writer>
+void Write(Writer& out, const aiCamera& ai)
 {
     out.Key(ai.mName.C_Str());
 
@@ -519,16 +768,16 @@ void Write(PrettyWriter<StringBuffer>& out, const aiCamera& ai)
             out.StartObject();
 
             out.Key("aspect_ratio");
-            out.Double(ai.mAspect);
+            out.Float(ai.mAspect);
 
             out.Key("zfar");
-            out.Double(ai.mClipPlaneFar);
+            out.Float(ai.mClipPlaneFar);
 
             out.Key("znear");
-            out.Double(ai.mClipPlaneNear);
+            out.Float(ai.mClipPlaneNear);
 
             out.Key("yfov");
-            out.Double(ai.mHorizontalFOV);
+            out.Float(ai.mHorizontalFOV);
 
             out.Key("up");
             Write(out, ai.mUp);
@@ -545,7 +794,200 @@ void Write(PrettyWriter<StringBuffer>& out, const aiCamera& ai)
     }
 }
 
-void WriteFormatInfo(PrettyWriter<StringBuffer>& out)
+template <typename Writer>
+void Write(Writer& out, const BufferBuilder::Accessor& ai)
+{
+	static const char* const types[] = {
+		"SCALAR", "VEC2", "VEC3", "VEC4"
+	};
+
+	out.StartObject();
+
+	out.Key("bufferView");
+	out.Uint(ai.bufferView);
+
+	out.Key("byteOffset");
+	out.Uint(0);
+
+	out.Key("byteStride");
+	out.Uint(0);
+
+	out.Key("componentType");
+	out.Uint(ai.componentType);
+
+	out.Key("count");
+	out.Uint(ai.count);
+
+	out.Key("type");
+	out.String(types[ai.numComponents - 1]);
+
+	if(ai.normalized) {
+		out.Key("normalized");
+		out.Bool(true);
+	}
+
+	if(ai.hasBounds) {
+		out.Key("min");
+		out.StartArray();
+		for(unsigned int c = 0; c < ai.numComponents; ++c) {
+			out.Float(ai.min[c]);
+		}
+		out.EndArray();
+
+		out.Key("max");
+		out.StartArray();
+		for(unsigned int c = 0; c < ai.numComponents; ++c) {
+			out.Float(ai.max[c]);
+		}
+		out.EndArray();
+	}
+
+	if(ai.encoding == BufferBuilder::Encoding_Linear) {
+		out.Key("extensions");
+		out.StartObject();
+		out.Key("WEB3D_quantized_attributes");
+		out.StartObject();
+
+		out.Key("decodedMin");
+		out.StartArray();
+		for(unsigned int c = 0; c < ai.numComponents; ++c) {
+			out.Float(ai.decodedMin[c]);
+		}
+		out.EndArray();
+
+		out.Key("decodedMax");
+		out.StartArray();
+		for(unsigned int c = 0; c < ai.numComponents; ++c) {
+			out.Float(ai.decodedMax[c]);
+		}
+		out.EndArray();
+
+		// column-major (n+1)x(n+1) matrix taking [0,65535] back to the decoded range
+		out.Key("decodeMatrix");
+		out.StartArray();
+		for(unsigned int col = 0; col <= ai.numComponents; ++col) {
+			for(unsigned int row = 0; row <= ai.numComponents; ++row) {
+				if(col == ai.numComponents) {
+					out.Float(row == col ? 1.f : ai.decodedMin[row]);
+				}
+				else {
+					out.Float(row == col ? (ai.decodedMax[col] - ai.decodedMin[col]) / 65535.f : 0.f);
+				}
+			}
+		}
+		out.EndArray();
+
+		out.EndObject();
+		out.EndObject();
+	}
+	else if(ai.encoding == BufferBuilder::Encoding_Octahedral) {
+		out.Key("extras");
+		out.StartObject();
+		out.Key("encoding");
+		out.String("octahedral");
+		out.EndObject();
+	}
+
+	out.EndObject();
+}
+
+template <typename Writer>
+void Write(Writer& out, const BufferBuilder::BufferView& ai)
+{
+	out.StartObject();
+
+	out.Key("buffer");
+	out.Uint(0);
+
+	out.Key("byteOffset");
+	out.Uint64(ai.byteOffset);
+
+	out.Key("byteLength");
+	out.Uint64(ai.byteLength);
+
+	if(ai.target) {
+		out.Key("target");
+		out.Uint(ai.target);
+	}
+
+	if(ai.filter != BufferBuilder::Filter_None) {
+		out.Key("extensions");
+		out.StartObject();
+		out.Key("ASSIMP2GLTF_buffer_compression");
+		out.StartObject();
+
+		out.Key("filter");
+		out.String(ai.filter == BufferBuilder::Filter_IndexDelta ? "index_delta" : "vertex_delta");
+
+		out.Key("compression");
+		out.String(ai.deflated ? "deflate" : "none");
+
+		out.Key("byteStride");
+		out.Uint(ai.byteStride);
+
+		out.Key("byteLength");
+		out.Uint64(ai.decodedLength);
+
+		out.EndObject();
+		out.EndObject();
+	}
+
+	out.EndObject();
+}
+
+template <typename Writer>
+void WriteBuffers(Writer& out, const BufferBuilder& buffers, const std::string& uri)
+{
+	out.Key("buffers");
+	out.StartArray();
+	out.StartObject();
+	// no uri means the data lives in the binary chunk of the container
+	if(!uri.empty()) {
+		out.Key("uri");
+		out.String(uri.c_str());
+	}
+	out.Key("byteLength");
+	out.Uint64(buffers.GetByteLength());
+	out.Key("type");
+	out.String("arraybuffer");
+	out.EndObject();
+	out.EndArray();
+
+	out.Key("bufferViews");
+	out.StartArray();
+	for(size_t n = 0; n < buffers.GetBufferViews().size(); ++n) {
+		Write(out,buffers.GetBufferViews()[n]);
+	}
+	out.EndArray();
+
+	out.Key("accessors");
+	out.StartArray();
+	bool quantized = false;
+	for(size_t n = 0; n < buffers.GetAccessors().size(); ++n) {
+		Write(out,buffers.GetAccessors()[n]);
+		quantized = quantized || buffers.GetAccessors()[n].encoding == BufferBuilder::Encoding_Linear;
+	}
+	out.EndArray();
+
+	bool compressed = false;
+	for(size_t n = 0; n < buffers.GetBufferViews().size(); ++n) {
+		compressed = compressed || buffers.GetBufferViews()[n].filter != BufferBuilder::Filter_None;
+	}
+	if(quantized || compressed) {
+		out.Key("extensionsUsed");
+		out.StartArray();
+		if(quantized) {
+			out.String("WEB3D_quantized_attributes");
+		}
+		if(compressed) {
+			out.String("ASSIMP2GLTF_buffer_compression");
+		}
+		out.EndArray();
+	}
+}
+
+template <typename Writer>
+void WriteFormatInfo(Writer& out)
 {
 	out.StartObject();
 	out.Key("format");
@@ -555,15 +997,158 @@ void WriteFormatInfo(PrettyWriter<StringBuffer>& out)
 	out.EndObject();
 }
 
-void Write(PrettyWriter<StringBuffer>& out, const aiScene& ai)
+// Write the items [0,count) of the current array, rendering them in parallel
+// on the pool. The output is identical to writing them one after another.
+template <typename Writer, typename Render>
+void WriteFragments(Writer& out, unsigned int count, Assimp::WorkerPool& pool, const Render& render)
+{
+	typedef typename Writer::FragmentWriter FragmentWriter;
+
+	// render a few items per thread at a time, so we don't need to
+	// hold the text for all of them in memory.
+	const unsigned int window = pool.GetNumThreads() * 4;
+	std::vector<StringBuffer> fragments(std::min(window, count));
+
+	JsonWriterState state;
+	for(unsigned int base = 0; base < count; base += window) {
+		const unsigned int num = std::min(window, count - base);
+
+		out.GetState(state);
+		pool.ParallelFor(num, [&](unsigned int i) {
+			JsonWriterState item_state(state);
+			item_state.levels.back().valueCount += i;
+
+			StringBuffer& sb = fragments[i];
+			sb.Clear();
+
+			FragmentWriter writer(sb);
+			writer.SetFloatDecimals(out.GetFloatDecimals());
+			writer.SetState(item_state);
+			render(writer, base + i);
+		});
+
+		for(unsigned int i = 0; i < num; ++i) {
+			out.AppendFragment(fragments[i].GetString(), fragments[i].GetSize(), 1);
+		}
+	}
+}
+
+// Write entry n of the meshes array: the unique meshes, followed by their levels of detail
+template <typename Writer>
+void WriteOutputMesh(Writer& out, unsigned int n, const ExportContext& ctx, const std::vector<BufferBuilder::MeshAccessors>& accessors)
 {
+	const UniqueContent& content = *ctx.content;
+	const unsigned int num_meshes = static_cast<unsigned int>(content.GetMeshes().size());
+	const BufferBuilder::MeshAccessors* const mesh_accessors = ctx.buffers ? &accessors[n] : NULL;
+	const std::vector<Assimp::Meshlet>* const meshlets = ctx.meshlets ? &(*ctx.meshlets)[n] : NULL;
+
+	if(n < num_meshes) {
+		const unsigned int source = content.GetMeshes()[n];
+		const aiMesh& mesh = *ctx.meshes->GetMeshes()[source];
+		Write(out,mesh,content.GetMaterial(mesh.mMaterialIndex),mesh_accessors,ctx.bounds->GetMesh(n),&ctx.lods->GetLevels(n),num_meshes,meshlets);
+	}
+	else {
+		const aiMesh& mesh = *ctx.lods->GetMeshes()[n - num_meshes];
+		Write(out,mesh,content.GetMaterial(mesh.mMaterialIndex),mesh_accessors,ctx.bounds->GetMesh(n),NULL,0,meshlets);
+	}
+}
+
+template <typename Writer>
+void Write(Writer& out, const aiScene& ai, const ExportContext& ctx)
+{
+	const std::vector<const aiMesh*>& meshes = ctx.meshes->GetMeshes();
+	const UniqueContent& content = *ctx.content;
+
+	// output meshes, materials and textures to write
+	const std::vector<unsigned int>& unique_meshes = content.GetMeshes();
+	const std::vector<unsigned int>& unique_materials = content.GetMaterials();
+	const std::vector<unsigned int>& unique_textures = content.GetTextures();
+	const unsigned int num_meshes = static_cast<unsigned int>(unique_meshes.size());
+
+	// levels of detail follow the unique meshes
+	const std::vector<const aiMesh*>& lod_meshes = ctx.lods->GetMeshes();
+	const unsigned int num_lods = static_cast<unsigned int>(lod_meshes.size());
+	const unsigned int num_textures = static_cast<unsigned int>(unique_textures.size());
+
+	unsigned int vertices, faces;
+	CountMeshes(meshes, vertices, faces);
+
+	// with binary buffers, all streams are laid out upfront so the
+	// accessor indices don't depend on the order meshes are written in.
+	std::vector<BufferBuilder::MeshAccessors> accessors;
+	if(ctx.buffers) {
+		if(ctx.profiler) {
+			ctx.profiler->BeginRegion("export:layout", vertices, faces);
+		}
+		accessors.resize(num_meshes + num_lods);
+		for(unsigned int n = 0; n < num_meshes; ++n) {
+			ctx.buffers->AddMesh(*meshes[unique_meshes[n]], accessors[n]);
+		}
+		for(unsigned int n = 0; n < num_lods; ++n) {
+			ctx.buffers->AddMesh(*lod_meshes[n], accessors[num_meshes + n]);
+		}
+		if(ctx.profiler) {
+			ctx.profiler->EndRegion("export:layout", vertices, faces);
+		}
+	}
+
+	if(ctx.profiler) {
+		ctx.profiler->BeginRegion("export:textures");
+	}
+
+	// embedded textures become image files. Compressed ones are taken as
+	// they are, uncompressed ones are encoded as PNG.
+	std::vector<TextureImage> images(num_textures);
+	std::vector< std::vector<unsigned char> > png(num_textures);
+	ctx.pool->ParallelFor(num_textures, [&](unsigned int n) {
+		const aiTexture& tex = *ai.mTextures[unique_textures[n]];
+		TextureImage& image = images[n];
+		image.bufferView = BufferBuilder::NO_ACCESSOR;
+
+		if(!tex.mHeight) {
+			image.data = reinterpret_cast<const unsigned char*>(tex.pcData);
+			image.size = tex.mWidth;
+			image.mimeType = GetImageMimeType(tex);
+			return;
+		}
+
+		if(tex.mWidth) {
+			EncodePNG(tex.pcData, tex.mWidth, tex.mHeight, png[n]);
+		}
+		image.data = png[n].empty() ? NULL : &png[n][0];
+		image.size = png[n].size();
+		image.mimeType = "image/png";
+	});
+
+	if(ctx.profiler) {
+		ctx.profiler->EndRegion("export:textures");
+	}
+
+	if(ctx.buffers) {
+		for(unsigned int n = 0; n < num_textures; ++n) {
+			images[n].bufferView = png[n].empty() ? ctx.buffers->AddBlob(images[n].data, images[n].size) : ctx.buffers->AddBlob(png[n]);
+		}
+
+		if(ctx.profiler) {
+			ctx.profiler->BeginRegion("export:compress");
+		}
+		ctx.buffers->Compress(*ctx.pool);
+		if(ctx.profiler) {
+			ctx.profiler->EndRegion("export:compress");
+		}
+	}
+
+	if(ctx.profiler) {
+		ctx.profiler->BeginRegion("export:document", vertices, faces);
+	}
+
 	out.StartObject();
 
 	out.Key("__metadata__");
 	WriteFormatInfo(out);
 
 	out.Key("rootnode");
-	Write(out,*ai.mRootNode);
+	Write(out,*ai.mRootNode,*ctx.meshes,content,*ctx.bounds);
 
 	out.Key("flags");
 	out.Uint(ai.mFlags);
@@ -571,8 +1156,15 @@ void Write(PrettyWriter<StringBuffer>& out, const aiScene& ai)
 	if(ai.HasMeshes()) {
 		out.Key("meshes");
 		out.StartArray();
-		for(unsigned int n = 0; n < ai.mNumMeshes; ++n) {
-			Write(out,*ai.mMeshes[n]);
+		if(ctx.pool->GetNumThreads() > 1) {
+			WriteFragments(out, num_meshes + num_lods, *ctx.pool, [&](typename Writer::FragmentWriter& w, unsigned int n) {
+				WriteOutputMesh(w,n,ctx,accessors);
+			});
+		}
+		else {
+			for(unsigned int n = 0; n < num_meshes + num_lods; ++n) {
+				WriteOutputMesh(out,n,ctx,accessors);
+			}
 		}
 		out.EndArray();
 	}
@@ -580,8 +1172,8 @@ void Write(PrettyWriter<StringBuffer>& out, const aiScene& ai)
 	if(ai.HasMaterials()) {
 		out.Key("materials");
 		out.StartArray();
-		for(unsigned int n = 0; n < ai.mNumMaterials; ++n) {
-			Write(out,*ai.mMaterials[n]);
+		for(size_t n = 0; n < unique_materials.size(); ++n) {
+			Write(out,*ai.mMaterials[unique_materials[n]],content);
 		}
 		out.EndArray();
 	}
@@ -589,8 +1181,15 @@ void Write(PrettyWriter<StringBuffer>& out, const aiScene& ai)
 	if(ai.HasAnimations()) {
 		out.Key("animations");
 		out.StartArray();
-		for(unsigned int n = 0; n < ai.mNumAnimations; ++n) {
-			Write(out,*ai.mAnimations[n]);
+		if(ctx.pool->GetNumThreads() > 1) {
+			WriteFragments(out, ai.mNumAnimations, *ctx.pool, [&](typename Writer::FragmentWriter& w, unsigned int n) {
+				Write(w,*ai.mAnimations[n]);
+			});
+		}
+		else {
+			for(unsigned int n = 0; n < ai.mNumAnimations; ++n) {
+				Write(out,*ai.mAnimations[n]);
+			}
 		}
 		out.EndArray();
 	}
@@ -616,43 +1215,318 @@ void Write(PrettyWriter<StringBuffer>& out, const aiScene& ai)
 	if(ai.HasTextures()) {
 		out.Key("textures");
 		out.StartArray();
-		for(unsigned int n = 0; n < ai.mNumTextures; ++n) {
-			Write(out,*ai.mTextures[n]);
+		for(unsigned int n = 0; n < num_textures; ++n) {
+			Write(out,*ai.mTextures[unique_textures[n]],images[n]);
 		}
 		out.EndArray();
 	}
+
+	if(ctx.buffers) {
+		WriteBuffers(out,*ctx.buffers,ctx.buffer_uri);
+	}
 	out.EndObject();
+
+	if(ctx.profiler) {
+		ctx.profiler->EndRegion("export:document", vertices, faces);
+	}
 }
 
+// Get the name of the binary sidecar file for a given output file, i.e.
+// foo/bar.gltf becomes foo/bar.bin
+std::string GetBufferFileName(const std::string& file)
+{
+	const std::string::size_type dot = file.find_last_of('.'), sep = file.find_last_of("/\\");
+	if (dot != std::string::npos && (sep == std::string::npos || dot > sep)) {
+		return file.substr(0, dot) + ".bin";
+	}
+	return file + ".bin";
+}
 
-void assimp2gltf(const char* file, Assimp::IOSystem* io, const aiScene* scene, const Assimp::ExportProperties*) 
+
+// Binary container layout: a 12 byte header followed by 4-byte aligned
+// chunks, each prefixed with its length and type, as in the GLB section
+// of the glTF 2.0 specification. The JSON chunk holds this exporter's own
+// document, not glTF 2.0, so the header has a magic of its own which glTF
+// 2.0 loaders reject right away instead of failing on the document.
+const uint32_t kContainerMagic = 0x42473241; // "A2GB"
+const uint32_t kContainerVersion = 1;
+const uint32_t kChunkJSON = 0x4E4F534A; // "JSON"
+const uint32_t kChunkBIN = 0x004E4942; // "BIN\0"
+
+size_t AlignChunk(size_t size)
+{
+	return (size + 3) & ~static_cast<size_t>(3);
+}
+
+void WriteContainer(Assimp::IOStream& out, const StringBuffer& json, const BufferBuilder& buffers)
 {
-	boost::scoped_ptr<Assimp::IOStream> outStream(io->Open(file,"wt"));
+	const size_t json_length = AlignChunk(json.GetSize());
+	const size_t bin_length = AlignChunk(buffers.GetByteLength());
+
+	const size_t total = 12 + 8 + json_length + (bin_length ? 8 + bin_length : 0);
+	if (total > std::numeric_limits<uint32_t>::max()) {
+		throw DeadlyExportError("scene is too large for a binary container (4 GiB limit)");
+	}
+
+	const uint32_t header[] = {
+		kContainerMagic, kContainerVersion, static_cast<uint32_t>(total)
+	};
+	out.Write(header, sizeof(header), 1);
+
+	// the JSON chunk is padded with spaces, the binary chunk with zeros
+	const uint32_t json_chunk[] = {
+		static_cast<uint32_t>(json_length), kChunkJSON
+	};
+	out.Write(json_chunk, sizeof(json_chunk), 1);
+	out.Write(json.GetString(), json.GetSize(), 1);
+	out.Write("   ", 1, json_length - json.GetSize());
+
+	if (bin_length) {
+		const uint32_t bin_chunk[] = {
+			static_cast<uint32_t>(bin_length), kChunkBIN
+		};
+		out.Write(bin_chunk, sizeof(bin_chunk), 1);
+
+		// vertex and index data goes straight from the meshes to the stream
+		buffers.WritePayload(out);
+		out.Write("\0\0\0", 1, bin_length - buffers.GetByteLength());
+	}
+}
+
+
+// Write the whole document to os, using the given kind of rapidjson writer
+template <typename DocumentWriter, typename OutputStream>
+void WriteDocument(OutputStream& os, const aiScene& scene, const ExportContext& ctx, int float_decimals)
+{
+	DocumentWriter writer(os);
+	writer.SetFloatDecimals(float_decimals);
+	Write(writer, scene, ctx);
+}
+
+
+void ExportScene(const char* file, Assimp::IOSystem* io, const aiScene* scene, const Assimp::ExportProperties* props, bool container) 
+{
+	boost::scoped_ptr<Assimp::IOStream> outStream(io->Open(file,container ? "wb" : "wt"));
     if (!outStream) {
-		throw std::exception("could not open output file");
+		throw DeadlyExportError("could not open output file: " + std::string(file));
 	}
 
-	// get a copy of the scene so we can modify it
-	aiScene* scenecopy_tmp;
-	aiCopyScene(scene, &scenecopy_tmp);
+	// the container always carries its own buffer
+	const bool binary_buffers = container || props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_BINARY_BUFFERS, false);
 
-	try {
-		// split meshes so they fit into a 16 bit index buffer
-		MeshSplitter splitter;
-		splitter.SetLimit(1 << 16);
-		splitter.Execute(scenecopy_tmp);
+	// split meshes so they fit into a 16 bit index buffer. The scene itself stays
+	// untouched, so only meshes which actually need to be split are copied.
+	// With 32 bit indices there is nothing to split.
+	MeshSplitter splitter;
+	splitter.SetLimit(props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_UINT32_INDICES, false) ? std::numeric_limits<unsigned int>::max() : (1 << 16));
 
-        StringBuffer sb;
-        PrettyWriter<StringBuffer> writer(sb);
+	const std::string split_mode = props->GetPropertyString(AI_CONFIG_EXPORT_GLTF_SPLIT_MODE, "order");
+	if (split_mode == "spatial") {
+		splitter.SetMode(MeshSplitter::Mode_Spatial);
+	}
+	else if (split_mode != "order") {
+		throw DeadlyExportError("unknown split mode: " + split_mode);
+	}
 
-        Write(writer, *scenecopy_tmp);
-        outStream->Write(sb.GetString(), sb.GetSize(), 1);
+	boost::scoped_ptr<Assimp::Profiling::Profiler> profiler(export_profile ? new Assimp::Profiling::Profiler(export_profile) : NULL);
+
+	if (profiler) {
+		profiler->BeginRegion("export:split", scene);
 	}
-	catch(...) {
-		aiFreeScene(scenecopy_tmp);
-		throw;
+
+	SplitMeshList meshes;
+	splitter.Execute(scene, meshes);
+
+	if (profiler) {
+		unsigned int vertices, faces;
+		CountMeshes(meshes.GetMeshes(), vertices, faces);
+		profiler->EndRegion("export:split", vertices, faces);
+	}
+
+	Deduplicator deduplicator;
+	deduplicator.SetEnabled(props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_DEDUPLICATE, false));
+
+	if (profiler) {
+		profiler->BeginRegion("export:dedup");
+	}
+
+	UniqueContent content;
+	deduplicator.Execute(scene, meshes, content);
+
+	if (profiler) {
+		profiler->EndRegion("export:dedup");
+	}
+
+	// inside a job of another pool, e.g. a --batch worker, all loops run inline anyway
+	const int threads = Assimp::WorkerPool::IsRunningJob() ? 1 : props->GetPropertyInteger(AI_CONFIG_EXPORT_GLTF_THREADS, 1);
+	Assimp::WorkerPool pool(threads);
+
+	// levels of detail are built for the unique meshes only
+	LodBuilder lod_builder;
+	lod_builder.SetRatios(props->GetPropertyString(AI_CONFIG_EXPORT_GLTF_LODS, ""));
+
+	std::vector<const aiMesh*> unique_meshes;
+	for (size_t i = 0; i < content.GetMeshes().size(); ++i) {
+		unique_meshes.push_back(meshes.GetMeshes()[content.GetMeshes()[i]]);
+	}
+
+	if (profiler) {
+		unsigned int vertices, faces;
+		CountMeshes(unique_meshes, vertices, faces);
+		profiler->BeginRegion("export:lods", vertices, faces);
+	}
+
+	LodList lods;
+	lod_builder.Execute(unique_meshes, lods, pool);
+
+	if (profiler) {
+		unsigned int vertices, faces;
+		CountMeshes(lods.GetMeshes(), vertices, faces);
+		profiler->EndRegion("export:lods", vertices, faces);
 	}
-	aiFreeScene(scenecopy_tmp);
+
+	// entries of the meshes array: the unique meshes, then their levels of detail
+	std::vector<const aiMesh*> output_meshes(unique_meshes);
+	output_meshes.insert(output_meshes.end(), lods.GetMeshes().begin(), lods.GetMeshes().end());
+
+	if (profiler) {
+		unsigned int vertices, faces;
+		CountMeshes(output_meshes, vertices, faces);
+		profiler->BeginRegion("export:bounds", vertices, faces);
+	}
+
+	SceneBounds bounds;
+	bounds.Execute(scene, output_meshes, meshes, content, pool);
+
+	if (profiler) {
+		unsigned int vertices, faces;
+		CountMeshes(output_meshes, vertices, faces);
+		profiler->EndRegion("export:bounds", vertices, faces);
+	}
+
+	// clusters are read off the face order, which the GenMeshlets step arranged.
+	// The limits must match the ones it ran with.
+	std::vector< std::vector<Assimp::Meshlet> > meshlets;
+	const bool write_meshlets = props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_MESHLETS, false);
+	if (write_meshlets) {
+		const int max_vertices = props->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES, AI_GM_DEFAULT_MAX_VERTICES);
+		const int max_faces = props->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES, AI_GM_DEFAULT_MAX_TRIANGLES);
+		if (max_vertices < 3 || max_faces < 1) {
+			throw DeadlyExportError("invalid meshlet limits");
+		}
+
+		if (profiler) {
+			unsigned int vertices, faces;
+			CountMeshes(output_meshes, vertices, faces);
+			profiler->BeginRegion("export:meshlets", vertices, faces);
+		}
+
+		meshlets.resize(output_meshes.size());
+		pool.ParallelFor(static_cast<unsigned int>(output_meshes.size()), [&](unsigned int i) {
+			Assimp::GenMeshletsProcess::GetMeshlets(output_meshes[i], max_vertices, max_faces, meshlets[i]);
+		});
+
+		if (profiler) {
+			unsigned int vertices, faces;
+			CountMeshes(output_meshes, vertices, faces);
+			profiler->EndRegion("export:meshlets", vertices, faces);
+		}
+	}
+
+	const int normal_bits = props->GetPropertyInteger(AI_CONFIG_EXPORT_GLTF_QUANTIZE_NORMAL_BITS, 8);
+	if (normal_bits != 8 && normal_bits != 16) {
+		throw DeadlyExportError("unsupported normal bits, must be 8 or 16");
+	}
+
+	BufferBuilder buffers;
+	buffers.SetQuantization(props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_QUANTIZE, false), normal_bits);
+
+	const std::string compression = props->GetPropertyString(AI_CONFIG_EXPORT_GLTF_COMPRESSION, "none");
+	if (compression == "filter") {
+		buffers.SetCompression(BufferBuilder::Compression_Filter);
+	}
+	else if (compression == "deflate") {
+		buffers.SetCompression(BufferBuilder::Compression_Deflate);
+	}
+	else if (compression != "none") {
+		throw DeadlyExportError("unknown buffer compression: " + compression);
+	}
+	const std::string buffer_file = GetBufferFileName(file);
+
+	// the uri is relative to the output file
+	const std::string::size_type sep = buffer_file.find_last_of("/\\");
+
+	ExportContext ctx;
+	ctx.meshes = &meshes;
+	ctx.content = &content;
+	ctx.lods = &lods;
+	ctx.bounds = &bounds;
+	ctx.meshlets = write_meshlets ? &meshlets : NULL;
+	ctx.buffers = binary_buffers ? &buffers : NULL;
+	ctx.buffer_uri = container ? std::string() : (sep == std::string::npos ? buffer_file : buffer_file.substr(sep + 1));
+	ctx.pool = &pool;
+	ctx.profiler = profiler.get();
+
+	const bool compact = props->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_COMPACT, false);
+	const int float_decimals = props->GetPropertyInteger(AI_CONFIG_EXPORT_GLTF_FLOAT_DECIMALS, -1);
+
+	if (container) {
+		// the container header needs the length of the JSON chunk upfront.
+		// All bulk data goes to the binary chunk, so the JSON is small.
+		StringBuffer sb;
+		if (compact) {
+			WriteDocument< JsonWriter< Writer<StringBuffer> > >(sb, *scene, ctx, float_decimals);
+		}
+		else {
+			WriteDocument< JsonWriter< PrettyWriter<StringBuffer> > >(sb, *scene, ctx, float_decimals);
+		}
+
+		if (profiler) {
+			profiler->BeginRegion("export:buffers");
+		}
+		WriteContainer(*outStream, sb, buffers);
+		if (profiler) {
+			profiler->EndRegion("export:buffers");
+		}
+	}
+	else {
+		// stream the document, memory usage is bounded by the
+		// size of the stream buffer regardless of the scene size.
+		IOStreamWriteStream os(*outStream);
+		if (compact) {
+			WriteDocument< JsonWriter< Writer<IOStreamWriteStream> > >(os, *scene, ctx, float_decimals);
+		}
+		else {
+			WriteDocument< JsonWriter< PrettyWriter<IOStreamWriteStream> > >(os, *scene, ctx, float_decimals);
+		}
+		os.Flush();
+	}
+
+	if (binary_buffers && !container) {
+		if (profiler) {
+			profiler->BeginRegion("export:buffers");
+		}
+		boost::scoped_ptr<Assimp::IOStream> bufferStream(io->Open(buffer_file.c_str(),"wb"));
+		if (!bufferStream) {
+			throw DeadlyExportError("could not open output .bin file: " + buffer_file);
+		}
+		buffers.WritePayload(*bufferStream);
+		if (profiler) {
+			profiler->EndRegion("export:buffers");
+		}
+	}
+}
+
+
+void assimp2gltf(const char* file, Assimp::IOSystem* io, const aiScene* scene, const Assimp::ExportProperties* props) 
+{
+	ExportScene(file, io, scene, props, false);
+}
+
+
+void assimp2glb(const char* file, Assimp::IOSystem* io, const aiScene* scene, const Assimp::ExportProperties* props) 
+{
+	ExportScene(file, io, scene, props, true);
 }
 
-} // 
+} //
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_JSON_WRITER
+#define INCLUDED_JSON_WRITER
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/prettywriter.h"
+
+#include "float_format.h"
+
+#include <vector>
+
+// ---------------------------------------------------------------------------
+/** Nesting state of a JsonWriter, i.e. the stack of open objects and
+ *  arrays along with the number of values written to each of them.
+ */
+struct JsonWriterState
+{
+	struct Level
+	{
+		size_t valueCount;
+		bool inArray;
+	};
+
+	std::vector<Level> levels;
+};
+
+template <typename Base>
+class JsonWriter;
+
+// ---------------------------------------------------------------------------
+/** Maps a rapidjson writer type to the same kind of writer producing its
+ *  output into a StringBuffer, used to render fragments of a document.
+ */
+template <typename Base>
+struct FragmentWriterOf;
+
+template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator>
+struct FragmentWriterOf< rapidjson::PrettyWriter<OutputStream, SourceEncoding, TargetEncoding, StackAllocator> >
+{
+	typedef JsonWriter< rapidjson::PrettyWriter<rapidjson::StringBuffer, SourceEncoding, TargetEncoding, StackAllocator> > Type;
+};
+
+template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator>
+struct FragmentWriterOf< rapidjson::Writer<OutputStream, SourceEncoding, TargetEncoding, StackAllocator> >
+{
+	typedef JsonWriter< rapidjson::Writer<rapidjson::StringBuffer, SourceEncoding, TargetEncoding, StackAllocator> > Type;
+};
+
+// ---------------------------------------------------------------------------
+/** rapidjson writer which can hand out and continue from its nesting
+ *  state.
+ *
+ *  This allows parts of a document to be rendered independently, i.e.
+ *  on different threads: a FragmentWriter which has been given the state
+ *  of the main writer produces exactly the bytes (separators and
+ *  indentation included) the main writer would have produced for the
+ *  same values. AppendFragment() then copies them to the output and
+ *  updates the main writer's state accordingly.
+ */
+template <typename Base>
+class JsonWriter : public Base
+{
+public:
+
+	typedef typename Base::Ch Ch;
+	typedef typename FragmentWriterOf<Base>::Type FragmentWriter;
+
+public:
+
+	template <typename OutputStream>
+	explicit JsonWriter(OutputStream& os)
+		: Base(os)
+		, float_decimals(-1)
+	{
+	}
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Write a single precision value. Unlike Double(), this only prints
+	 *  the digits needed to read back the same float, or the number of
+	 *  decimal places set by SetFloatDecimals().
+	 */
+	bool Float(float f) {
+		NumberPrefix(static_cast<Base*>(this));
+
+		char buffer[25];
+		const char* const end = float_decimals < 0
+			? FormatFloat(f, buffer)
+			: FormatFloatFixed(f, static_cast<unsigned int>(float_decimals), buffer);
+
+		for (const char* p = buffer; p != end; ++p) {
+			Base::os_->Put(*p);
+		}
+		return true;
+	}
+
+	// -------------------------------------------------------------------
+	/** Set the number of decimal places Float() rounds to, -1 to print
+	 *  the shortest representation which round-trips.
+	 */
+	void SetFloatDecimals(int decimals) {
+		float_decimals = decimals;
+	}
+
+	int GetFloatDecimals() const {
+		return float_decimals;
+	}
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Get the current nesting state */
+	void GetState(JsonWriterState& state) {
+		typedef typename Base::Level Level;
+
+		const size_t depth = Base::level_stack_.GetSize() / sizeof(Level);
+		const Level* const levels = Base::level_stack_.template Bottom<Level>();
+
+		state.levels.resize(depth);
+		for (size_t i = 0; i < depth; ++i) {
+			state.levels[i].valueCount = levels[i].valueCount;
+			state.levels[i].inArray = levels[i].inArray;
+		}
+	}
+
+	// -------------------------------------------------------------------
+	/** Continue writing at the given nesting state. Only valid on a writer
+	 *  which hasn't written anything yet.
+	 */
+	void SetState(const JsonWriterState& state) {
+		typedef typename Base::Level Level;
+
+		RAPIDJSON_ASSERT(Base::level_stack_.Empty());
+		for (std::vector<JsonWriterState::Level>::const_iterator it = state.levels.begin(); it != state.levels.end(); ++it) {
+			Level* const level = new (Base::level_stack_.template Push<Level>()) Level((*it).inArray);
+			level->valueCount = (*it).valueCount;
+		}
+		Base::hasRoot_ = true;
+	}
+
+	// -------------------------------------------------------------------
+	/** Append output rendered by a FragmentWriter which was started from
+	 *  this writer's current state.
+	 *  @param values Number of values the fragment added to the innermost
+	 *    open object or array.
+	 */
+	void AppendFragment(const Ch* data, size_t size, size_t values) {
+		for (size_t i = 0; i < size; ++i) {
+			Base::os_->Put(data[i]);
+		}
+		Base::level_stack_.template Top<typename Base::Level>()->valueCount += values;
+	}
+
+private:
+
+	// separators and indentation as the base writer emits them for a number
+	template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator>
+	void NumberPrefix(rapidjson::PrettyWriter<OutputStream, SourceEncoding, TargetEncoding, StackAllocator>*) {
+		Base::PrettyPrefix(rapidjson::kNumberType);
+	}
+
+	template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator>
+	void NumberPrefix(rapidjson::Writer<OutputStream, SourceEncoding, TargetEncoding, StackAllocator>*) {
+		Base::Prefix(rapidjson::kNumberType);
+	}
+
+private:
+
+	int float_decimals;
+};
+
+#endif // INCLUDED_JSON_WRITER
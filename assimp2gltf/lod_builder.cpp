@@ -0,0 +1,89 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "lod_builder.h"
+
+#include <assimp/scene.h>
+#include <assimp/../../code/WorkerPool.h>
+#include <assimp/../../code/Exceptional.h>
+#include <assimp/../../code/SimplifyMeshes.h>
+
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+// ------------------------------------------------------------------------------------------------
+LodList :: ~LodList()
+{
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		delete meshes[i];
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void LodBuilder :: SetRatios(const std::string& list)
+{
+	ratios.clear();
+
+	std::istringstream ss(list);
+	for (std::string item; std::getline(ss, item, ','); ) {
+		char* end = NULL;
+		const float ratio = static_cast<float>(strtod(item.c_str(), &end));
+
+		if (end == item.c_str() || *end || !(ratio > 0.f && ratio < 1.f) || (!ratios.empty() && ratio >= ratios.back())) {
+			throw DeadlyExportError("invalid LOD ratios: " + list);
+		}
+		ratios.push_back(ratio);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void LodBuilder :: Execute(const std::vector<const aiMesh*>& meshes, LodList& out, Assimp::WorkerPool& pool) const
+{
+	const unsigned int count = static_cast<unsigned int>(meshes.size());
+	if (ratios.empty()) {
+		out.levels.resize(count);
+		return;
+	}
+
+	std::vector< std::vector<std::pair<aiMesh*, float> > > chains(count);
+
+	pool.ParallelFor(count, [&](unsigned int n) {
+		Assimp::SimplifyMeshesProcess simplifier;
+		const aiMesh* source = meshes[n];
+
+		// errors add up along the chain, as each level is simplified from the one before
+		float error = 0.f;
+		for (size_t i = 0; i < ratios.size(); ++i) {
+			const unsigned int target = static_cast<unsigned int>(meshes[n]->mNumFaces * ratios[i]);
+
+			float step_error;
+			aiMesh* const level = simplifier.SimplifyMesh(source, target, std::numeric_limits<float>::max(), step_error);
+			if (!level) {
+				break;
+			}
+
+			error += step_error;
+			chains[n].push_back(std::make_pair(level, error));
+			source = level;
+		}
+	});
+
+	out.levels.resize(count);
+	for (unsigned int n = 0; n < count; ++n) {
+		for (size_t i = 0; i < chains[n].size(); ++i) {
+			LodLevel level;
+			level.mesh = static_cast<unsigned int>(out.meshes.size());
+			level.error = chains[n][i].second;
+
+			out.meshes.push_back(chains[n][i].first);
+			out.levels[n].push_back(level);
+		}
+	}
+}
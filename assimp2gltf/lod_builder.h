@@ -0,0 +1,104 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_LOD_BUILDER
+#define INCLUDED_LOD_BUILDER
+
+#include <string>
+#include <vector>
+
+struct aiMesh;
+
+namespace Assimp {
+	class WorkerPool;
+}
+
+// ---------------------------------------------------------------------------
+/** One simplified version of a mesh */
+struct LodLevel
+{
+	/** Index of the simplified mesh in LodList::GetMeshes() */
+	unsigned int mesh;
+
+	/** Estimate of the deviation of the simplified surface from the full
+	 *  mesh, in units of the mesh's positions: the sum of the errors the
+	 *  simplifier reported for this level and all levels before it */
+	float error;
+};
+
+// ---------------------------------------------------------------------------
+/** Levels of detail for a list of meshes. The simplified meshes are owned
+ *  by this object, the levels of each source mesh are contiguous in the
+ *  output list and ordered from fine to coarse.
+ */
+class LodList
+{
+	friend class LodBuilder;
+
+public:
+
+	LodList() {}
+	~LodList();
+
+public:
+
+	/** All simplified meshes, in order */
+	const std::vector<const aiMesh*>& GetMeshes() const {
+		return meshes;
+	}
+
+	/** Levels of a source mesh, empty if there are none */
+	const std::vector<LodLevel>& GetLevels(unsigned int source) const {
+		return levels[source];
+	}
+
+private:
+
+	// Prohibit copy constructor & assignment operator.
+	LodList(const LodList&);
+	LodList& operator=(const LodList&);
+
+	std::vector<const aiMesh*> meshes;
+	std::vector< std::vector<LodLevel> > levels;
+};
+
+// ---------------------------------------------------------------------------
+/** Builds a chain of simplified versions for each mesh, each level from the
+ *  one before. A chain ends early once a mesh can't be simplified further.
+ */
+class LodBuilder
+{
+public:
+
+	// -------------------------------------------------------------------
+	/** Set the levels to build from a comma separated list of face ratios,
+	 *  relative to the full mesh, i.e. "0.5,0.25". The ratios must be
+	 *  decreasing and within (0,1). Throws DeadlyExportError if not.
+	 */
+	void SetRatios(const std::string& list);
+
+	bool HasLevels() const {
+		return !ratios.empty();
+	}
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Build the levels of all meshes, in parallel on the pool.
+	 * @param meshes Meshes to build levels for.
+	 * @param out Receives the levels, indexed like meshes.
+	 */
+	void Execute(const std::vector<const aiMesh*>& meshes, LodList& out, Assimp::WorkerPool& pool) const;
+
+private:
+
+	std::vector<float> ratios;
+};
+
+#endif // INCLUDED_LOD_BUILDER
@@ -13,15 +13,34 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 #include <assimp/version.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <assimp/../../code/WorkerPool.h>
 
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/prettywriter.h"
+
+#include "gltf_config.h"
+#include "import_settings.h"
+#include "conversion_cache.h"
 
 // json_exporter.cpp
 extern Assimp::Exporter::ExportFormatEntry assimp2gltf_desc;
+extern Assimp::Exporter::ExportFormatEntry assimp2glb_desc;
+void SetExportProfile(Assimp::ProfileRegionList* profile);
 
 int unrecog_exit(int ex = -1)
 {
-	std::cout << "usage: assimp2gltf [--log --verbose] input [output]" << std::endl;
+	std::cout << "usage: assimp2gltf [--log --verbose --profile name --pp steps --weld mode --binary --glb --uint32-indices --split mode --quantize --normal-bits n --compress mode --compact --precision n --dedup --lods ratios --meshlets --threads n --cache dir --stats file] input [output]" << std::endl;
+	std::cout << "       assimp2gltf [flags] [--jobs n] --batch list.txt" << std::endl;
 	return ex;
 }
 
@@ -40,15 +59,319 @@ void printhelp()
 {
 }
 
+void SetupExporter(Assimp::Exporter& exp)
+{
+	exp.RegisterExporter(assimp2gltf_desc);
+	exp.RegisterExporter(assimp2glb_desc);
+}
+
+// Outcome of converting one file
+struct ConvertResult
+{
+	ConvertResult()
+		: cached()
+	{}
+
+	std::string error;
+	bool cached;
+
+	// import and export measurements, only taken if the importer measures
+	Assimp::ProfileRegionList profile;
+};
+
+// Convert in to out, going through cache if not NULL. Returns 0 on success and the exit code
+// for the failure otherwise, with the reason in result.error.
+int ConvertFile(Assimp::Importer& imp, Assimp::Exporter& exp, const std::string& in, const std::string& out,
+	const PostProcessing& pp, const char* format, const Assimp::ExportProperties& props, const ConversionCache* cache,
+	ConvertResult& result)
+{
+	// without a complete key the result can't be stored either
+	uint64_t key = 0;
+	const bool keyed = cache && cache->GetKey(in, out, key);
+	if (keyed && cache->Restore(key, out)) {
+		result.cached = true;
+		return 0;
+	}
+
+	const bool measure = imp.GetPropertyBool(AI_CONFIG_GLOB_MEASURE_TIME);
+	std::string& error = result.error;
+
+	// watch the files read and written to know what the result depends on
+	RecordingIOSystem* import_io = NULL, *export_io = NULL;
+	if (cache) {
+		imp.SetIOHandler(import_io = new RecordingIOSystem());
+		exp.SetIOHandler(export_io = new RecordingIOSystem());
+	}
+
+	int ret = 0;
+	try {
+		const aiScene* const sc = ReadScene(imp, in, pp);
+		result.profile = imp.GetProfile();
+		if (!sc) {
+			error = std::string("failure reading file: ") + imp.GetErrorString();
+			ret = -3;
+		}
+		else {
+			SetExportProfile(measure ? &result.profile : NULL);
+			if(aiReturn_SUCCESS != exp.Export(sc,format,out,0u,&props)) {
+				error = std::string("failure exporting file: ") + exp.GetErrorString();
+				ret = -4;
+			}
+			else if (keyed) {
+				cache->Store(key, out, *import_io, *export_io);
+			}
+		}
+	}
+	catch (const std::exception& e) {
+		error = std::string("unexpected error: ") + e.what();
+		ret = -4;
+	}
+	SetExportProfile(NULL);
+
+	// keep memory usage down between files
+	imp.FreeScene();
+	exp.FreeBlob();
+	return ret;
+}
+
+// Get the output file for a --batch input: same path, with the extension of the format
+std::string GetBatchOutput(const std::string& in, const char* format)
+{
+	const std::string::size_type dot = in.find_last_of('.'), sep = in.find_last_of("/\\");
+	const std::string base = (dot == std::string::npos || (sep != std::string::npos && dot < sep)) ? in : in.substr(0, dot);
+	return base + (strcmp(format,"assimp.glb") ? ".gltf" : ".glb");
+}
+
+// Write the measurements for all converted files as JSON
+bool WriteStats(const char* stats_file, const std::vector<std::pair<std::string, std::string> >& files,
+	const std::vector<ConvertResult>& results)
+{
+	rapidjson::StringBuffer sb;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> out(sb);
+
+	out.StartObject();
+	out.Key("files");
+	out.StartArray();
+	for (size_t i = 0; i < files.size(); ++i) {
+		const ConvertResult& result = results[i];
+
+		out.StartObject();
+		out.Key("input");
+		out.String(files[i].first.c_str());
+		out.Key("output");
+		out.String(files[i].second.c_str());
+		out.Key("status");
+		out.String(result.cached ? "cached" : (result.error.empty() ? "ok" : "failed"));
+
+		out.Key("regions");
+		out.StartArray();
+		for (size_t n = 0; n < result.profile.size(); ++n) {
+			const Assimp::ProfileRegion& r = result.profile[n];
+			out.StartObject();
+			out.Key("name");
+			out.String(r.mName.c_str());
+			out.Key("wall");
+			out.Double(r.mWallTime);
+			out.Key("cpu");
+			out.Double(r.mCpuTime);
+			out.Key("peak_rss_delta");
+			out.Uint64(r.mPeakMemoryDelta);
+			out.Key("vertices_in");
+			out.Uint(r.mVerticesIn);
+			out.Key("faces_in");
+			out.Uint(r.mFacesIn);
+			out.Key("vertices_out");
+			out.Uint(r.mVerticesOut);
+			out.Key("faces_out");
+			out.Uint(r.mFacesOut);
+			out.EndObject();
+		}
+		out.EndArray();
+		out.EndObject();
+	}
+	out.EndArray();
+	out.EndObject();
+
+	std::ofstream f(stats_file);
+	f << sb.GetString() << std::endl;
+	if (!f) {
+		std::cerr << "failure writing stats file: " << stats_file << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Convert all files listed in list_file (- for stdin), one per line. A line may give the output
+// file after the input, separated by a tab, otherwise it is derived from the input file. Empty
+// lines and lines starting with # are skipped.
+int RunBatch(const char* list_file, const PostProcessing& pp, const char* format, const Assimp::ExportProperties& props,
+	unsigned int jobs, int threads, const ConversionCache* cache, const char* stats_file)
+{
+	std::ifstream list_stream;
+	if (strcmp(list_file,"-")) {
+		list_stream.open(list_file);
+		if (!list_stream) {
+			std::cerr << "failure reading batch list: " << list_file << std::endl;
+			return -3;
+		}
+	}
+	std::istream& list = list_stream.is_open() ? list_stream : std::cin;
+
+	std::vector<std::pair<std::string, std::string> > files;
+	std::string line;
+	while (std::getline(list, line)) {
+		if (!line.empty() && line[line.size() - 1] == '\r') {
+			line.resize(line.size() - 1);
+		}
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		const std::string::size_type tab = line.find('\t');
+		const std::string in = line.substr(0, tab);
+		files.push_back(std::make_pair(in, tab == std::string::npos ? GetBatchOutput(in, format) : line.substr(tab + 1)));
+	}
+
+	std::vector<ConvertResult> results(files.size());
+	std::atomic<unsigned int> next(0);
+	std::mutex report;
+
+	// one task per worker, each with its own importer and exporter which
+	// are then reused for all files the worker picks up.
+	Assimp::WorkerPool pool(jobs);
+	pool.ParallelFor(pool.GetNumThreads(), [&](unsigned int) {
+		Assimp::Importer imp;
+		SetupImporter(imp, stats_file != NULL, threads);
+
+		Assimp::Exporter exp;
+		SetupExporter(exp);
+
+		for (unsigned int i = next++; i < files.size(); i = next++) {
+			if (ConvertFile(imp, exp, files[i].first, files[i].second, pp, format, props, cache, results[i])) {
+				std::lock_guard<std::mutex> lock(report);
+				std::cerr << files[i].first << ": " << results[i].error << std::endl;
+			}
+		}
+	});
+
+	unsigned int failed = 0, from_cache = 0;
+	for (size_t i = 0; i < files.size(); ++i) {
+		failed += !results[i].error.empty();
+		from_cache += results[i].cached;
+	}
+
+	const bool stats_ok = !stats_file || WriteStats(stats_file, files, results);
+
+	std::cerr << "converted " << files.size() - failed << " of " << files.size() << " files";
+	if (cache) {
+		std::cerr << " (" << from_cache << " from cache)";
+	}
+	if (failed) {
+		std::cerr << ", " << failed << " failed:" << std::endl;
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (!results[i].error.empty()) {
+				std::cerr << "  " << files[i].first << ": " << results[i].error << std::endl;
+			}
+		}
+		return -6;
+	}
+	std::cerr << std::endl;
+	return stats_ok ? 0 : -7;
+}
+
 int main (int argc, char *argv[])
 {
 	if (argc == 1) {
 		return unrecog_exit(-1);
 	}
 
+	Assimp::ExportProperties props;
+	PostProcessing pp;
+	const char* pp_steps = NULL;
+	bool meshlets = false;
+	const char* format = "assimp.gltf";
+	const char* batch = NULL;
+	const char* cache_dir = NULL;
+	const char* stats_file = NULL;
+	unsigned int jobs = 0;
+	int threads = 1;
+
 	int nextarg = 1;
 	while(nextarg < argc && argv[nextarg][0] == '-') {
-		if (!strcmp(argv[nextarg],"--help")) {
+		if (!strcmp(argv[nextarg],"--profile") && nextarg+1 < argc) {
+			if (!SetPostProcessingProfile(pp, argv[++nextarg])) {
+				std::cerr << "unknown post processing profile: " << argv[nextarg] << std::endl;
+				return unrecog_exit(-2);
+			}
+		}
+		else if (!strcmp(argv[nextarg],"--pp") && nextarg+1 < argc) {
+			pp_steps = argv[++nextarg];
+		}
+		else if (!strcmp(argv[nextarg],"--weld") && nextarg+1 < argc) {
+			const char* const mode = argv[++nextarg];
+			if (strcmp(mode,"exact") && strcmp(mode,"tolerant")) {
+				std::cerr << "unknown weld mode: " << mode << std::endl;
+				return unrecog_exit(-2);
+			}
+			pp.exact_weld = !strcmp(mode,"exact");
+		}
+		else if (!strcmp(argv[nextarg],"--binary")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_BINARY_BUFFERS, true);
+		}
+		else if (!strcmp(argv[nextarg],"--glb")) {
+			format = "assimp.glb";
+		}
+		else if (!strcmp(argv[nextarg],"--uint32-indices")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_UINT32_INDICES, true);
+		}
+		else if (!strcmp(argv[nextarg],"--split") && nextarg+1 < argc) {
+			props.SetPropertyString(AI_CONFIG_EXPORT_GLTF_SPLIT_MODE, argv[++nextarg]);
+		}
+		else if (!strcmp(argv[nextarg],"--quantize")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_QUANTIZE, true);
+		}
+		else if (!strcmp(argv[nextarg],"--normal-bits") && nextarg+1 < argc) {
+			props.SetPropertyInteger(AI_CONFIG_EXPORT_GLTF_QUANTIZE_NORMAL_BITS, atoi(argv[++nextarg]));
+		}
+		else if (!strcmp(argv[nextarg],"--compress") && nextarg+1 < argc) {
+			props.SetPropertyString(AI_CONFIG_EXPORT_GLTF_COMPRESSION, argv[++nextarg]);
+		}
+		else if (!strcmp(argv[nextarg],"--compact")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_COMPACT, true);
+		}
+		else if (!strcmp(argv[nextarg],"--precision") && nextarg+1 < argc) {
+			props.SetPropertyInteger(AI_CONFIG_EXPORT_GLTF_FLOAT_DECIMALS, atoi(argv[++nextarg]));
+		}
+		else if (!strcmp(argv[nextarg],"--dedup")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_DEDUPLICATE, true);
+		}
+		else if (!strcmp(argv[nextarg],"--lods") && nextarg+1 < argc) {
+			props.SetPropertyString(AI_CONFIG_EXPORT_GLTF_LODS, argv[++nextarg]);
+		}
+		else if (!strcmp(argv[nextarg],"--meshlets")) {
+			props.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_MESHLETS, true);
+			// the importer runs GenMeshlets with these, see SetupImporter()
+			props.SetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES, kMeshletMaxVertices);
+			props.SetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES, kMeshletMaxTriangles);
+			meshlets = true;
+		}
+		else if (!strcmp(argv[nextarg],"--threads") && nextarg+1 < argc) {
+			threads = atoi(argv[++nextarg]);
+			props.SetPropertyInteger(AI_CONFIG_EXPORT_GLTF_THREADS, threads);
+		}
+		else if (!strcmp(argv[nextarg],"--batch") && nextarg+1 < argc) {
+			batch = argv[++nextarg];
+		}
+		else if (!strcmp(argv[nextarg],"--jobs") && nextarg+1 < argc) {
+			jobs = static_cast<unsigned int>(atoi(argv[++nextarg]));
+		}
+		else if (!strcmp(argv[nextarg],"--cache") && nextarg+1 < argc) {
+			cache_dir = argv[++nextarg];
+		}
+		else if (!strcmp(argv[nextarg],"--stats") && nextarg+1 < argc) {
+			stats_file = argv[++nextarg];
+		}
+		else if (!strcmp(argv[nextarg],"--help")) {
 			printhelp();
 			return 0;
 		}
@@ -59,49 +382,86 @@ int main (int argc, char *argv[])
 		++nextarg;
 	}
 
-	if (argc < nextarg+1) {
+	// steps are toggled on top of the profile, wherever it was given
+	if (pp_steps && !TogglePostProcessingSteps(pp, pp_steps)) {
+		std::cerr << "invalid post processing steps: " << pp_steps << std::endl;
 		return unrecog_exit(-2);
 	}
 
-	const char* in = argv[nextarg], *out = (argc < nextarg+2 ? NULL : argv[nextarg+1]);
-	
-	Assimp::Importer imp;
+	// the exporter reads the clusters off the face order arranged by this step
+	if (meshlets) {
+		pp.flags |= aiProcess_GenMeshlets;
+	}
 
-	// instruct aiProcess_FindDegenerates to drop degenerates 
-	imp.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
-	// instruct aiProcess_SortByPrimitiveType to drop line and point meshes
-	imp.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+	std::unique_ptr<ConversionCache> cache;
+	if (cache_dir) {
+		cache.reset(new ConversionCache(cache_dir, format, pp, props));
+	}
+
+	if (batch) {
+		return RunBatch(batch, pp, format, props, jobs, threads, cache.get(), stats_file);
+	}
+
+	if (argc < nextarg+1) {
+		return unrecog_exit(-2);
+	}
 
-	// instruct aiProcess_GenSmoothNormals to not smooth normals with an angle of more than 70deg
-	imp.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 70.0f);
-	// instruct aiProcess_CalcTangents to not smooth normals with an angle of more than 70deg
-	imp.SetPropertyFloat(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, 70.0f);
+	const char* in = argv[nextarg], *out = (argc < nextarg+2 ? NULL : argv[nextarg+1]);
 
-	const aiScene* const sc = imp.ReadFile(in,aiProcessPreset_TargetRealtime_MaxQuality);
-	if (!sc) {
-		std::cerr << "failure reading file: " << in << std::endl;
-		return -3;
+	// the binary sidecar file can't go to stdout along with the json
+	if (!out && props.GetPropertyBool(AI_CONFIG_EXPORT_GLTF_BINARY_BUFFERS)) {
+		std::cerr << "--binary requires an output file" << std::endl;
+		return unrecog_exit(-2);
 	}
+	
+	Assimp::Importer imp;
+	SetupImporter(imp, stats_file != NULL, threads);
 
 	Assimp::Exporter exp;
-	exp.RegisterExporter(assimp2gltf_desc);
+	SetupExporter(exp);
+
+	std::vector<std::pair<std::string, std::string> > files(1, std::make_pair(std::string(in), std::string(out ? out : "-")));
+	std::vector<ConvertResult> results(1);
 
 	if(out) {
-		if(aiReturn_SUCCESS != exp.Export(sc,"assimp.gltf",out)) {
-			std::cerr << "failure exporting file: " << out << ": " << exp.GetErrorString() << std::endl;
-			return -4;
+		const int ret = ConvertFile(imp, exp, in, out, pp, format, props, cache.get(), results[0]);
+		if (ret) {
+			std::cerr << in << ": " << results[0].error << std::endl;
+		}
+		if (stats_file && !WriteStats(stats_file, files, results) && !ret) {
+			return -7;
 		}
+		return ret;
 	}
 	else {
+		const aiScene* const sc = ReadScene(imp, in, pp);
+		if (!sc) {
+			std::cerr << "failure reading file: " << in << std::endl;
+			return -3;
+		}
+
 		// write to stdout, but we might do better than using ExportToBlob()
-		const aiExportDataBlob* const blob = exp.ExportToBlob(sc,"assimp.gltf");
+		results[0].profile = imp.GetProfile();
+		SetExportProfile(stats_file ? &results[0].profile : NULL);
+		const aiExportDataBlob* const blob = exp.ExportToBlob(sc,format,0u,&props);
+		SetExportProfile(NULL);
 		if(!blob) {
 			std::cerr << "failure exporting to (stdout) " << exp.GetErrorString() << std::endl;
 			return -5;
 		}
 
-		const std::string s(static_cast<char*>( blob->data), blob->size);
-		std::cout << s << std::endl;
+		if (!strcmp(format,"assimp.glb")) {
+			std::cout.write(static_cast<char*>(blob->data), blob->size);
+			std::cout.flush();
+		}
+		else {
+			const std::string s(static_cast<char*>( blob->data), blob->size);
+			std::cout << s << std::endl;
+		}
+
+		if (stats_file && !WriteStats(stats_file, files, results)) {
+			return -7;
+		}
 	}
 	return 0;
 }
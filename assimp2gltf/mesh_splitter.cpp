@@ -9,320 +9,341 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 
 
 #include "mesh_splitter.h"
+#include "scene_bounds.h"
 
 #include <assimp/scene.h>
 
+// grab DeadlyExportError from assimp
+#include <assimp/../../code/Exceptional.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
 // ----------------------------------------------------------------------------
 // Note: this is largely based on assimp's SplitLargeMeshes_Vertex process.
 // it is refactored and the coding style is slightly improved, though.
 // ----------------------------------------------------------------------------
 
+namespace {
+
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void MeshSplitter :: Execute( aiScene* pScene)
+// Bone weights of a mesh grouped by vertex: the weights of vertex i are
+// weights[start[i]] to weights[start[i+1]-1], first = bone index.
+struct VertexWeightTable
 {
-	std::vector<std::pair<aiMesh*, unsigned int> > source_mesh_map;
-
-	for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
-		SplitMesh(a, pScene->mMeshes[a],source_mesh_map);
-	}
+	std::vector<unsigned int> start;
+	std::vector<std::pair<unsigned int, float> > weights;
 
-	const unsigned int size = static_cast<unsigned int>(source_mesh_map.size());
-	if (size != pScene->mNumMeshes)
+	void Build(const aiMesh* mesh)
 	{
-		// it seems something has been split. rebuild the mesh list
-		delete[] pScene->mMeshes;
-		pScene->mNumMeshes = size;
-		pScene->mMeshes = new aiMesh*[size]();
+		start.assign(mesh->mNumVertices + 1, 0u);
+		for (unsigned int i = 0; i < mesh->mNumBones; ++i) {
+			const aiBone* const bone = mesh->mBones[i];
+			for (unsigned int a = 0; a < bone->mNumWeights; ++a) {
+				++start[bone->mWeights[a].mVertexId + 1];
+			}
+		}
+		for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+			start[i + 1] += start[i];
+		}
 
-		for (unsigned int i = 0; i < size;++i) {
-			pScene->mMeshes[i] = source_mesh_map[i].first;
+		std::vector<unsigned int> cursor(start.begin(), start.end() - 1);
+		weights.resize(start.back());
+		for (unsigned int i = 0; i < mesh->mNumBones; ++i) {
+			const aiBone* const bone = mesh->mBones[i];
+			for (unsigned int a = 0; a < bone->mNumWeights; ++a) {
+				const aiVertexWeight& weight = bone->mWeights[a];
+				weights[cursor[weight.mVertexId]++] = std::make_pair(i, weight.mWeight);
+			}
 		}
+	}
+};
 
-		// now we need to update all nodes
-		UpdateNode(pScene->mRootNode,source_mesh_map);
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+T* Gather(const T* source, const std::vector<unsigned int>& vertex_source)
+{
+	T* const out = new T[vertex_source.size()];
+	for (size_t i = 0; i < vertex_source.size(); ++i) {
+		out[i] = source[vertex_source[i]];
 	}
+	return out;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Spread the lower 10 bits of v so there are two zero bits between each of them
+uint32_t SpreadBits10(uint32_t v)
+{
+	v &= 0x3ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v <<  8)) & 0x0300f00f;
+	v = (v | (v <<  4)) & 0x030c30c3;
+	v = (v | (v <<  2)) & 0x09249249;
+	return v;
+}
 
 // ------------------------------------------------------------------------------------------------
-void MeshSplitter :: UpdateNode(aiNode* pcNode, const std::vector<std::pair<aiMesh*, unsigned int> >& source_mesh_map)
+// Get the cell of v in a grid of 1024 cells starting at min, written so NaNs end up in the first cell
+uint32_t GetGridCell(float v, float min, float scale)
 {
-	// TODO: should better use std::(multi)set for source_mesh_map.
-
-	// for every index in out list build a new entry
-	std::vector<unsigned int> aiEntries;
-	aiEntries.reserve(pcNode->mNumMeshes + 1);
-	for (unsigned int i = 0; i < pcNode->mNumMeshes;++i)	{
-		for (unsigned int a = 0, end = static_cast<unsigned int>(source_mesh_map.size()); a < end;++a)	{
-			if (source_mesh_map[a].second == pcNode->mMeshes[i])	{
-				aiEntries.push_back(a);
-			}
+	const float cell = (v - min) * scale + 0.5f;
+	return cell > 0.f ? static_cast<uint32_t>(std::min(cell, 1023.f)) : 0u;
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+// Splits the meshes of the given scene into a separate list, leaving the scene unchanged.
+void MeshSplitter :: Execute( const aiScene* pScene, SplitMeshList& out)
+{
+	out.meshes.reserve(pScene->mNumMeshes);
+	out.first.reserve(pScene->mNumMeshes + 1);
+
+	for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+		const aiMesh* const mesh = pScene->mMeshes[a];
+		out.first.push_back(static_cast<unsigned int>(out.meshes.size()));
+
+		if (mesh->mNumVertices <= LIMIT) {
+			out.meshes.push_back(mesh);
+			continue;
 		}
+
+		SplitMesh(mesh, out);
 	}
+	out.first.push_back(static_cast<unsigned int>(out.meshes.size()));
+}
 
-	// now build the new list
-	delete pcNode->mMeshes;
-	pcNode->mNumMeshes = static_cast<unsigned int>(aiEntries.size());
-	pcNode->mMeshes = new unsigned int[pcNode->mNumMeshes];
+// ------------------------------------------------------------------------------------------------
+SplitMeshList :: ~SplitMeshList()
+{
+	for (std::vector<aiMesh*>::const_iterator it = owned.begin(); it != owned.end(); ++it) {
+		aiMesh* const mesh = *it;
 
-	for (unsigned int b = 0; b < pcNode->mNumMeshes;++b) {
-		pcNode->mMeshes[b] = aiEntries[b];
+		// the face indices live in index_storage, keep ~aiFace from deleting them
+		for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+			mesh->mFaces[i].mIndices = NULL;
+		}
+		delete mesh;
 	}
 
-	// recursively update children
-	for (unsigned int i = 0, end = pcNode->mNumChildren; i < end;++i)	{
-		UpdateNode ( pcNode->mChildren[i], source_mesh_map );
+	for (std::vector<unsigned int*>::const_iterator it = index_storage.begin(); it != index_storage.end(); ++it) {
+		delete[] *it;
 	}
-	return;
 }
 
-#define WAS_NOT_COPIED 0xffffffff
-
-typedef std::pair <unsigned int,float> PerVertexWeight;
-typedef std::vector	<PerVertexWeight> VertexWeightTable;
-
 // ------------------------------------------------------------------------------------------------
-VertexWeightTable* ComputeVertexBoneWeightTable(const aiMesh* pMesh)
+void MeshSplitter :: NextGeneration()
 {
-	if (!pMesh || !pMesh->mNumVertices || !pMesh->mNumBones) {
-		return NULL;
+	if (!++generation) {
+		// wrapped around, old stamps could match again
+		std::fill(stamp.begin(), stamp.end(), 0u);
+		generation = 1;
 	}
+}
 
-	VertexWeightTable* const avPerVertexWeights = new VertexWeightTable[pMesh->mNumVertices];
-	for (unsigned int i = 0; i < pMesh->mNumBones;++i)	{
+// ------------------------------------------------------------------------------------------------
+// Sets up face_order for a mesh according to the current mode.
+void MeshSplitter :: ComputeFaceOrder(const aiMesh* mesh)
+{
+	face_order.resize(mesh->mNumFaces);
+	if (mode == Mode_FaceOrder || !mesh->HasPositions()) {
+		for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+			face_order[i] = i;
+		}
+		return;
+	}
 
-		aiBone* bone = pMesh->mBones[i];
-		for (unsigned int a = 0; a < bone->mNumWeights;++a)	{
-			const aiVertexWeight& weight = bone->mWeights[a];
-			avPerVertexWeights[weight.mVertexId].push_back( std::make_pair(i,weight.mWeight) );
+	// quantize face centroids to a 1024^3 grid spanning the mesh and sort
+	// the faces by the Morton codes of their grid cells.
+	aiVector3D min, max;
+	ComputeBox(mesh->mVertices, mesh->mNumVertices, min, max);
+	const aiVector3D extent = max - min;
+	const aiVector3D scale(extent.x > 0.f ? 1023.f / extent.x : 0.f,
+		extent.y > 0.f ? 1023.f / extent.y : 0.f,
+		extent.z > 0.f ? 1023.f / extent.z : 0.f);
+
+	std::vector<uint64_t> keys(mesh->mNumFaces);
+	for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+		const aiFace& face = mesh->mFaces[i];
+
+		aiVector3D centroid;
+		for (unsigned int v = 0; v < face.mNumIndices; ++v) {
+			centroid += mesh->mVertices[face.mIndices[v]];
+		}
+		if (face.mNumIndices) {
+			centroid /= static_cast<float>(face.mNumIndices);
 		}
+
+		const uint32_t code = SpreadBits10(GetGridCell(centroid.x, min.x, scale.x)) |
+			(SpreadBits10(GetGridCell(centroid.y, min.y, scale.y)) << 1) |
+			(SpreadBits10(GetGridCell(centroid.z, min.z, scale.z)) << 2);
+
+		// the face index in the lower bits keeps the order of faces in the same cell
+		keys[i] = (static_cast<uint64_t>(code) << 32) | i;
+	}
+	std::sort(keys.begin(), keys.end());
+
+	for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+		face_order[i] = static_cast<unsigned int>(keys[i]);
 	}
-	return avPerVertexWeights;
 }
 
 // ------------------------------------------------------------------------------------------------
-void MeshSplitter :: SplitMesh(unsigned int a, aiMesh* in_mesh,
-	std::vector<std::pair<aiMesh*, unsigned int> >& source_mesh_map)
+// Appends the submeshes for a mesh exceeding the limit to out, which owns them. The input mesh
+// is left untouched. The faces of each submesh index into a single block, which out keeps in its
+// index_storage. Faces are taken in face_order, each submesh ends at the first face which would
+// push it over the limit.
+void MeshSplitter :: SplitMesh(const aiMesh* in_mesh, SplitMeshList& out)
 {
-	// TODO: should better use std::(multi)set for source_mesh_map.
-
-	if (in_mesh->mNumVertices <= LIMIT)	{
-		source_mesh_map.push_back(std::make_pair(in_mesh,a));
-		return;
+	// build a per-vertex weight list if necessary
+	VertexWeightTable weight_table;
+	if (in_mesh->HasBones()) {
+		weight_table.Build(in_mesh);
 	}
+	std::vector< std::vector<aiVertexWeight> > bone_weights(in_mesh->mNumBones);
 
-	// build a per-vertex weight list if necessary
-	VertexWeightTable* avPerVertexWeights = ComputeVertexBoneWeightTable(in_mesh);
+	if (remap.size() < in_mesh->mNumVertices) {
+		remap.resize(in_mesh->mNumVertices);
+		stamp.resize(in_mesh->mNumVertices, 0u);
+	}
 
-	// we need to split this mesh into sub meshes. Estimate submesh size
-	const unsigned int sub_meshes = (in_mesh->mNumVertices / LIMIT) + 1;
+	ComputeFaceOrder(in_mesh);
 
-	// create a std::vector<unsigned int> to remember which vertices have already 
-	// been copied and to which position (i.e. output index)
-	std::vector<unsigned int> was_copied_to;
-	was_copied_to.resize(in_mesh->mNumVertices,WAS_NOT_COPIED);
+	unsigned int base = 0;
+	while (base < in_mesh->mNumFaces) {
+		NextGeneration();
 
-	// Try to find a good estimate for the number of output faces
-	// per mesh. Add 12.5% as buffer
-	unsigned int size_estimated = in_mesh->mNumFaces / sub_meshes;
-	size_estimated += size_estimated / 8;
+		vertex_source.clear();
+		face_sizes.clear();
+		indices.clear();
 
-	// now generate all submeshes
-	unsigned int base = 0;
-	while (true) {
-		const unsigned int out_vertex_index = LIMIT;
+		// pick faces and assign output vertices. This only touches the
+		// index buffer, attributes are gathered once the size is known.
+		unsigned int primitive_types = 0;
+		for (; base < in_mesh->mNumFaces; ++base) {
+			const aiFace& face = in_mesh->mFaces[face_order[base]];
 
-		aiMesh* out_mesh = new aiMesh();			
-		out_mesh->mNumVertices = 0;
-		out_mesh->mMaterialIndex = in_mesh->mMaterialIndex;
+			// doesn't catch degenerates but is quite fast
+			unsigned int iNeed = 0;
+			for (unsigned int v = 0; v < face.mNumIndices;++v)	{
+				iNeed += stamp[face.mIndices[v]] != generation;
+			}
+			if (vertex_source.size() + iNeed > LIMIT)	{
+				if (face_sizes.empty()) {
+					throw DeadlyExportError("face has more vertices than the split limit allows");
+				}
+				break;
+			}
 
-		// the name carries the adjacency information between the meshes
-		out_mesh->mName = in_mesh->mName;
+			for (unsigned int v = 0; v < face.mNumIndices;++v) {
+				const unsigned int index = face.mIndices[v];
+				if (stamp[index] != generation) {
+					stamp[index] = generation;
+					remap[index] = static_cast<unsigned int>(vertex_source.size());
+					vertex_source.push_back(index);
+				}
+				indices.push_back(remap[index]);
+			}
+			face_sizes.push_back(face.mNumIndices);
 
-		typedef std::vector<aiVertexWeight> BoneWeightList;
-		if (in_mesh->HasBones())	{
-			out_mesh->mBones = new aiBone*[in_mesh->mNumBones]();
+			switch (face.mNumIndices)
+			{
+			case 1:
+				primitive_types |= aiPrimitiveType_POINT;
+				break;
+			case 2:
+				primitive_types |= aiPrimitiveType_LINE;
+				break;
+			case 3:
+				primitive_types |= aiPrimitiveType_TRIANGLE;
+				break;
+			default:
+				primitive_types |= aiPrimitiveType_POLYGON;
+			}
 		}
 
-		// clear the temporary helper array
-		if (base)	{
-			std::fill(was_copied_to.begin(), was_copied_to.end(), WAS_NOT_COPIED);
-		}
+		aiMesh* const out_mesh = new aiMesh();
+		out_mesh->mPrimitiveTypes = primitive_types;
+		out_mesh->mMaterialIndex = in_mesh->mMaterialIndex;
 
-		std::vector<aiFace> vFaces;
+		// the name carries the adjacency information between the meshes
+		out_mesh->mName = in_mesh->mName;
 
-		// reserve enough storage for most cases
+		// copy the vertices, in order of first use
+		out_mesh->mNumVertices = static_cast<unsigned int>(vertex_source.size());
 		if (in_mesh->HasPositions()) {
-			out_mesh->mVertices = new aiVector3D[out_vertex_index];
+			out_mesh->mVertices = Gather(in_mesh->mVertices, vertex_source);
 		}
 
 		if (in_mesh->HasNormals()) {
-			out_mesh->mNormals = new aiVector3D[out_vertex_index];
+			out_mesh->mNormals = Gather(in_mesh->mNormals, vertex_source);
 		}
 
 		if (in_mesh->HasTangentsAndBitangents())	{
-			out_mesh->mTangents = new aiVector3D[out_vertex_index];
-			out_mesh->mBitangents = new aiVector3D[out_vertex_index];
+			out_mesh->mTangents = Gather(in_mesh->mTangents, vertex_source);
+			out_mesh->mBitangents = Gather(in_mesh->mBitangents, vertex_source);
 		}
 
 		for (unsigned int c = 0; in_mesh->HasVertexColors(c);++c)	{
-			out_mesh->mColors[c] = new aiColor4D[out_vertex_index];
+			out_mesh->mColors[c] = Gather(in_mesh->mColors[c], vertex_source);
 		}
 
 		for (unsigned int c = 0; in_mesh->HasTextureCoords(c);++c)	{
 			out_mesh->mNumUVComponents[c] = in_mesh->mNumUVComponents[c];
-			out_mesh->mTextureCoords[c] = new aiVector3D[out_vertex_index];
+			out_mesh->mTextureCoords[c] = Gather(in_mesh->mTextureCoords[c], vertex_source);
 		}
-		vFaces.reserve(size_estimated);
 
-		// (we will also need to copy the array of indices)
-		while (base < in_mesh->mNumFaces) {
-			const unsigned int iNumIndices = in_mesh->mFaces[base].mNumIndices;
-
-			// doesn't catch degenerates but is quite fast
-			unsigned int iNeed = 0;
-			for (unsigned int v = 0; v < iNumIndices;++v)	{
-				unsigned int index = in_mesh->mFaces[base].mIndices[v];
-
-				// check whether we do already have this vertex
-				if (WAS_NOT_COPIED == was_copied_to[index])	{
-					iNeed++; 
-				}
-			}
-			if (out_mesh->mNumVertices + iNeed > out_vertex_index)	{
-				// don't use this face
-				break;
-			}
+		// the faces share one index block
+		unsigned int* const index_block = new unsigned int[std::max(indices.size(), size_t(1))];
+		out.index_storage.push_back(index_block);
+		if (!indices.empty()) {
+			::memcpy(index_block, &indices[0], indices.size() * sizeof(unsigned int));
+		}
 
-			vFaces.push_back(aiFace());
-			aiFace& rFace = vFaces.back();
+		out_mesh->mNumFaces = static_cast<unsigned int>(face_sizes.size());
+		out_mesh->mFaces = new aiFace[out_mesh->mNumFaces];
 
-			// setup face type and number of indices
-			rFace.mNumIndices = iNumIndices;
-			rFace.mIndices = new unsigned int[iNumIndices];
+		unsigned int* cursor = index_block;
+		for (unsigned int p = 0; p < out_mesh->mNumFaces;++p) {
+			out_mesh->mFaces[p].mNumIndices = face_sizes[p];
+			out_mesh->mFaces[p].mIndices = cursor;
+			cursor += face_sizes[p];
+		}
 
-			// need to update the output primitive types
-			switch (rFace.mNumIndices)
-			{
-			case 1:
-				out_mesh->mPrimitiveTypes |= aiPrimitiveType_POINT;
-				break;
-			case 2:
-				out_mesh->mPrimitiveTypes |= aiPrimitiveType_LINE;
-				break;
-			case 3:
-				out_mesh->mPrimitiveTypes |= aiPrimitiveType_TRIANGLE;
-				break;
-			default:
-				out_mesh->mPrimitiveTypes |= aiPrimitiveType_POLYGON;
+		// collect the bone weights of the copied vertices, bones without
+		// any weights in this submesh are dropped.
+		if (in_mesh->HasBones()) {
+			for (unsigned int v = 0; v < out_mesh->mNumVertices; ++v) {
+				const unsigned int src = vertex_source[v];
+				for (unsigned int w = weight_table.start[src]; w < weight_table.start[src + 1]; ++w) {
+					bone_weights[weight_table.weights[w].first].push_back(aiVertexWeight(v, weight_table.weights[w].second));
+				}
 			}
 
-			// and copy the contents of the old array, offset them by current base
-			for (unsigned int v = 0; v < iNumIndices;++v) {
-				const unsigned int index = in_mesh->mFaces[base].mIndices[v];
-
-				// check whether we do already have this vertex
-				if (WAS_NOT_COPIED != was_copied_to[index]) {
-					rFace.mIndices[v] = was_copied_to[index];
+			out_mesh->mBones = new aiBone*[in_mesh->mNumBones]();
+			for (unsigned int k = 0; k < in_mesh->mNumBones;++k) {
+				std::vector<aiVertexWeight>& weight_list = bone_weights[k];
+				if (weight_list.empty()) {
 					continue;
 				}
 
-				// copy positions
-				out_mesh->mVertices[out_mesh->mNumVertices] = (in_mesh->mVertices[index]);
-
-				// copy normals
-				if (in_mesh->HasNormals()) {
-					out_mesh->mNormals[out_mesh->mNumVertices] = (in_mesh->mNormals[index]);
-				}
-
-				// copy tangents/bi-tangents
-				if (in_mesh->HasTangentsAndBitangents()) {
-					out_mesh->mTangents[out_mesh->mNumVertices] = (in_mesh->mTangents[index]);
-					out_mesh->mBitangents[out_mesh->mNumVertices] = (in_mesh->mBitangents[index]);
-				}
-
-				// texture coordinates
-				for (unsigned int c = 0;  c < AI_MAX_NUMBER_OF_TEXTURECOORDS;++c) {
-					if (in_mesh->HasTextureCoords( c)) {
-						out_mesh->mTextureCoords[c][out_mesh->mNumVertices] = in_mesh->mTextureCoords[c][index];
-					}
-				}
-				// vertex colors 
-				for (unsigned int c = 0;  c < AI_MAX_NUMBER_OF_COLOR_SETS;++c) {
-					if (in_mesh->HasVertexColors( c)) {
-						out_mesh->mColors[c][out_mesh->mNumVertices] = in_mesh->mColors[c][index];
-					}
-				}
-				// check whether we have bone weights assigned to this vertex
-				rFace.mIndices[v] = out_mesh->mNumVertices;
-				if (avPerVertexWeights) {
-					VertexWeightTable& table = avPerVertexWeights[ out_mesh->mNumVertices ];
-					for (VertexWeightTable::const_iterator iter = table.begin(), end = table.end(); iter != end;++iter) {
-						// allocate the bone weight array if necessary and store it in the mBones field (HACK!)
-						BoneWeightList* weight_list = reinterpret_cast<BoneWeightList*>(out_mesh->mBones[(*iter).first]);
-						if (!weight_list) {
-							weight_list = new BoneWeightList();
-							out_mesh->mBones[(*iter).first] = reinterpret_cast<aiBone*>(weight_list);
-						}
-						weight_list->push_back(aiVertexWeight(out_mesh->mNumVertices,(*iter).second));
-					}
-				}
+				const aiBone* const bone_in = in_mesh->mBones[k];
+				aiBone* const bone_out = new aiBone();
+				out_mesh->mBones[out_mesh->mNumBones++] = bone_out;
 
-				was_copied_to[index] = out_mesh->mNumVertices;
-				out_mesh->mNumVertices++;
-			}
-			base++;
-			if(out_mesh->mNumVertices == out_vertex_index) {
-				// break here. The face is only added if it was complete
-				break;
-			}
-		}
+				bone_out->mName = aiString(bone_in->mName);
+				bone_out->mOffsetMatrix = bone_in->mOffsetMatrix;
+				bone_out->mNumWeights = static_cast<unsigned int>(weight_list.size());
+				bone_out->mWeights = new aiVertexWeight[bone_out->mNumWeights];
+				::memcpy(bone_out->mWeights, &weight_list[0], bone_out->mNumWeights * sizeof(aiVertexWeight));
 
-		// check which bones we'll need to create for this submesh
-		if (in_mesh->HasBones()) {
-			aiBone** ppCurrent = out_mesh->mBones;
-			for (unsigned int k = 0; k < in_mesh->mNumBones;++k) {
-				// check whether the bone exists
-				BoneWeightList* const weight_list = reinterpret_cast<BoneWeightList*>(out_mesh->mBones[k]);
-
-				if (weight_list) {
-					const aiBone* const bone_in = in_mesh->mBones[k];
-					aiBone* const bone_out = new aiBone();
-					*ppCurrent++ = bone_out;
-					bone_out->mName = aiString(bone_in->mName);
-					bone_out->mOffsetMatrix =bone_in->mOffsetMatrix;
-					bone_out->mNumWeights = (unsigned int)weight_list->size();
-					bone_out->mWeights = new aiVertexWeight[bone_out->mNumWeights];
-
-					// copy the vertex weights
-					::memcpy(bone_out->mWeights, &(*weight_list)[0],bone_out->mNumWeights * sizeof(aiVertexWeight));
-
-					delete weight_list;
-					out_mesh->mNumBones++;
-				}
+				weight_list.clear();
 			}
 		}
 
-		// copy the face list to the mesh
-		out_mesh->mFaces = new aiFace[vFaces.size()];
-		out_mesh->mNumFaces = (unsigned int)vFaces.size();
-
-		for (unsigned int p = 0; p < out_mesh->mNumFaces;++p) {
-			out_mesh->mFaces[p] = vFaces[p];
-		}
-
 		// add the newly created mesh to the list
-		source_mesh_map.push_back(std::make_pair(out_mesh,a));
-
-		if (base == in_mesh->mNumFaces) {
-			break;
-		}
+		out.meshes.push_back(out_mesh);
+		out.owned.push_back(out_mesh);
 	}
-
-	// delete the per-vertex weight list again
-	delete[] avPerVertexWeights;
-
-	// now delete the old mesh data
-	delete in_mesh;
 }
@@ -19,7 +19,60 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 
 struct aiScene;
 struct aiMesh;
-struct aiNode;
+
+// ---------------------------------------------------------------------------
+/** Result of a non-destructive split. Meshes which don't exceed the limit
+ *  are referenced as they are, only meshes which had to be split are
+ *  replaced by new submeshes owned by this object. The submeshes of a
+ *  source mesh are contiguous in the output list.
+ */
+class SplitMeshList
+{
+	friend class MeshSplitter;
+
+public:
+
+	SplitMeshList() {}
+	~SplitMeshList();
+
+public:
+
+	/** Output meshes, in order */
+	const std::vector<const aiMesh*>& GetMeshes() const {
+		return meshes;
+	}
+
+	/** Index of the first output mesh generated from a source mesh */
+	unsigned int GetFirst(unsigned int source) const {
+		return first[source];
+	}
+
+	/** Number of output meshes generated from a source mesh */
+	unsigned int GetCount(unsigned int source) const {
+		return first[source + 1] - first[source];
+	}
+
+	/** Check whether any mesh had to be split */
+	bool HasSplits() const {
+		return !owned.empty();
+	}
+
+private:
+
+	// Prohibit copy constructor & assignment operator.
+	SplitMeshList(const SplitMeshList&);
+	SplitMeshList& operator=(const SplitMeshList&);
+
+	std::vector<const aiMesh*> meshes;
+
+	// first output mesh per source mesh, with one extra entry at the end
+	std::vector<unsigned int> first;
+
+	std::vector<aiMesh*> owned;
+
+	// face indices of the owned meshes, one block per mesh
+	std::vector<unsigned int*> index_storage;
+};
 
 // ---------------------------------------------------------------------------
 /** Splits meshes of unique vertices into meshes with no more vertices than
@@ -28,6 +81,26 @@ struct aiNode;
 class MeshSplitter 
 {
 
+public:
+
+	enum Mode
+	{
+		// fill each submesh with faces in their original order
+		Mode_FaceOrder,
+
+		// fill each submesh with faces in Morton order of their centroids,
+		// which keeps submeshes spatially compact
+		Mode_Spatial
+	};
+
+public:
+
+	MeshSplitter()
+		: LIMIT(1 << 16)
+		, mode(Mode_FaceOrder)
+		, generation()
+	{}
+
 public:
 	
 	void SetLimit(unsigned int l) {
@@ -38,24 +111,54 @@ public:
 		return LIMIT;
 	}
 
+	void SetMode(Mode m) {
+		mode = m;
+	}
+
+	Mode GetMode() const {
+		return mode;
+	}
+
 public:
 
 	// -------------------------------------------------------------------
-	/** Executes the post processing step on the given imported data.
-	 * At the moment a process is not supposed to fail.
+	/** Split the meshes of a scene without touching the scene itself.
+	 * Meshes within the limit are not copied, see SplitMeshList.
 	 * @param pScene The imported data to work at.
+	 * @param out Receives the list of output meshes.
 	 */
-	void Execute( aiScene* pScene);
+	void Execute( const aiScene* pScene, SplitMeshList& out);
 
 
 private:
 
-	void UpdateNode(aiNode* pcNode, const std::vector<std::pair<aiMesh*, unsigned int> >& source_mesh_map);
-	void SplitMesh (unsigned int index, aiMesh* mesh, std::vector<std::pair<aiMesh*, unsigned int> >& source_mesh_map);
+	void SplitMesh (const aiMesh* mesh, SplitMeshList& out);
+
+	void NextGeneration();
+	void ComputeFaceOrder(const aiMesh* mesh);
 
 public:
 
 	unsigned int LIMIT;
+
+private:
+
+	Mode mode;
+
+	// output index of each source vertex, valid where the stamp
+	// matches the current generation. Bumping the generation
+	// invalidates all entries at once for the next submesh.
+	std::vector<unsigned int> remap;
+	std::vector<unsigned int> stamp;
+	unsigned int generation;
+
+	// order in which faces are assigned to submeshes
+	std::vector<unsigned int> face_order;
+
+	// per submesh scratch buffers, kept to reuse their storage
+	std::vector<unsigned int> vertex_source;
+	std::vector<unsigned int> face_sizes;
+	std::vector<unsigned int> indices;
 };
 
 #endif // INCLUDED_MESH_SPLITTER
@@ -0,0 +1,163 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "png_encoder.h"
+
+#include <assimp/texture.h>
+
+// grab DeadlyExportError from assimp
+#include <assimp/../../code/Exceptional.h>
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const unsigned int kBytesPerPixel = 4;
+
+// ------------------------------------------------------------------------------------------------
+void PutU32(std::vector<unsigned char>& out, uint32_t v)
+{
+	out.push_back(static_cast<unsigned char>(v >> 24));
+	out.push_back(static_cast<unsigned char>(v >> 16));
+	out.push_back(static_cast<unsigned char>(v >> 8));
+	out.push_back(static_cast<unsigned char>(v));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Append a chunk with its length and CRC
+void PutChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data, size_t size)
+{
+	PutU32(out, static_cast<uint32_t>(size));
+
+	const size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	if (size) {
+		out.insert(out.end(), data, data + size);
+	}
+	PutU32(out, static_cast<uint32_t>(crc32(0, &out[start], static_cast<uInt>(out.size() - start))));
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned char Paeth(int a, int b, int c)
+{
+	const int p = a + b - c;
+	const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+	if (pa <= pb && pa <= pc) {
+		return static_cast<unsigned char>(a);
+	}
+	return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Filter one row with all five PNG filters and keep the one with the lowest sum of absolute
+// (signed) values, the usual heuristic for picking the most compressible one.
+void FilterRow(const unsigned char* row, const unsigned char* prev, size_t size, unsigned char* out,
+	unsigned char* scratch)
+{
+	unsigned int best_sum = ~0u;
+	for (unsigned int type = 0; type < 5; ++type) {
+		unsigned char* const f = type ? scratch : out + 1;
+
+		unsigned int sum = 0;
+		for (size_t i = 0; i < size; ++i) {
+			const int a = i >= kBytesPerPixel ? row[i - kBytesPerPixel] : 0;
+			const int b = prev ? prev[i] : 0;
+			const int c = prev && i >= kBytesPerPixel ? prev[i - kBytesPerPixel] : 0;
+
+			unsigned char v = row[i];
+			switch (type)
+			{
+			case 1:
+				v -= a;
+				break;
+			case 2:
+				v -= b;
+				break;
+			case 3:
+				v -= (a + b) / 2;
+				break;
+			case 4:
+				v -= Paeth(a, b, c);
+				break;
+			}
+			f[i] = v;
+			sum += v < 128 ? v : 256 - v;
+		}
+
+		if (sum < best_sum) {
+			best_sum = sum;
+			out[0] = static_cast<unsigned char>(type);
+			if (type) {
+				::memcpy(out + 1, scratch, size);
+			}
+		}
+	}
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+void EncodePNG(const aiTexel* texels, unsigned int width, unsigned int height, std::vector<unsigned char>& out)
+{
+	const size_t row_size = static_cast<size_t>(width) * kBytesPerPixel;
+
+	// aiTexel is BGRA, PNG wants RGBA. Rows are filtered straight into
+	// the zlib input, each prefixed by its filter type.
+	std::vector<unsigned char> rows[2] = {
+		std::vector<unsigned char>(row_size), std::vector<unsigned char>(row_size)
+	};
+	std::vector<unsigned char> scratch(row_size);
+	std::vector<unsigned char> filtered((row_size + 1) * height);
+
+	for (unsigned int y = 0; y < height; ++y) {
+		unsigned char* const row = &rows[y & 1][0];
+		const aiTexel* const src = texels + static_cast<size_t>(y) * width;
+		for (unsigned int x = 0; x < width; ++x) {
+			row[x * 4 + 0] = src[x].r;
+			row[x * 4 + 1] = src[x].g;
+			row[x * 4 + 2] = src[x].b;
+			row[x * 4 + 3] = src[x].a;
+		}
+
+		FilterRow(row, y ? &rows[(y + 1) & 1][0] : NULL, row_size, &filtered[(row_size + 1) * y], &scratch[0]);
+	}
+
+	uLongf length = compressBound(static_cast<uLong>(filtered.size()));
+	std::vector<unsigned char> idat(length);
+	if (compress2(&idat[0], &length, &filtered[0], static_cast<uLong>(filtered.size()), Z_DEFAULT_COMPRESSION) != Z_OK) {
+		throw DeadlyExportError("failed to compress texture data");
+	}
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+	out.clear();
+	out.reserve(length + 64);
+	out.insert(out.end(), signature, signature + 8);
+
+	// 8 bit truecolor with alpha, default compression/filter method, not interlaced
+	unsigned char header[13] = {};
+	header[0] = static_cast<unsigned char>(width >> 24);
+	header[1] = static_cast<unsigned char>(width >> 16);
+	header[2] = static_cast<unsigned char>(width >> 8);
+	header[3] = static_cast<unsigned char>(width);
+	header[4] = static_cast<unsigned char>(height >> 24);
+	header[5] = static_cast<unsigned char>(height >> 16);
+	header[6] = static_cast<unsigned char>(height >> 8);
+	header[7] = static_cast<unsigned char>(height);
+	header[8] = 8;
+	header[9] = 6;
+
+	PutChunk(out, "IHDR", header, sizeof(header));
+	PutChunk(out, "IDAT", &idat[0], length);
+	PutChunk(out, "IEND", NULL, 0);
+}
@@ -0,0 +1,24 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_PNG_ENCODER
+#define INCLUDED_PNG_ENCODER
+
+#include <vector>
+
+struct aiTexel;
+
+// ------------------------------------------------------------------------------------------------
+/** Encode an uncompressed embedded texture as 8 bit RGBA PNG.
+ *  @param texels width*height texels, row by row starting at the top.
+ *  @param out Receives the PNG file.
+ */
+void EncodePNG(const aiTexel* texels, unsigned int width, unsigned int height, std::vector<unsigned char>& out);
+
+#endif // INCLUDED_PNG_ENCODER
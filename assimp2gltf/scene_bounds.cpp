@@ -0,0 +1,255 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "scene_bounds.h"
+#include "mesh_splitter.h"
+#include "deduplicator.h"
+
+#include <assimp/scene.h>
+#include <assimp/../../code/WorkerPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	define ASSIMP2GLTF_SSE
+#	include <xmmintrin.h>
+#endif
+
+namespace {
+
+#ifdef ASSIMP2GLTF_SSE
+
+static_assert(sizeof(aiVector3D) == 3 * sizeof(float), "aiVector3D must be tightly packed");
+
+// ------------------------------------------------------------------------------------------------
+// Load 4 points and transpose them to one register per component
+inline void LoadTransposed(const aiVector3D* v, __m128& x, __m128& y, __m128& z)
+{
+	// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3. aiVector3D is a packed
+	// struct, so the unaligned loads are done by memcpy.
+	__m128 a, b, c;
+	memcpy(&a, v, sizeof(a));
+	memcpy(&b, reinterpret_cast<const char*>(v) + 16, sizeof(b));
+	memcpy(&c, reinterpret_cast<const char*>(v) + 32, sizeof(c));
+
+	const __m128 xy = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));	// x2 y2 x3 y3
+	const __m128 yz = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));	// y0 z0 y1 z1
+
+	x = _mm_shuffle_ps(a, xy, _MM_SHUFFLE(2, 0, 3, 0));
+	y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+	z = _mm_shuffle_ps(yz, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+// ------------------------------------------------------------------------------------------------
+inline float HorizontalMin(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline float HorizontalMax(__m128 v)
+{
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+
+#endif // ASSIMP2GLTF_SSE
+
+// ------------------------------------------------------------------------------------------------
+// Get the largest squared distance of an array of points from a center
+float ComputeSquaredRadius(const aiVector3D* v, unsigned int count, const aiVector3D& center)
+{
+	float radius = 0.f;
+	unsigned int i = 0;
+
+#ifdef ASSIMP2GLTF_SSE
+	const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+	__m128 r = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		__m128 x, y, z;
+		LoadTransposed(v + i, x, y, z);
+		x = _mm_sub_ps(x, cx);
+		y = _mm_sub_ps(y, cy);
+		z = _mm_sub_ps(z, cz);
+		r = _mm_max_ps(r, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+	}
+	radius = HorizontalMax(r);
+#endif
+
+	for (; i < count; ++i) {
+		radius = std::max(radius, (v[i] - center).SquareLength());
+	}
+	return radius;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the bounds of a box transformed by a matrix: each corner of the result takes the smaller
+// and larger product of each matrix element with the extents of the box, as in Arvo's method.
+void TransformBox(const aiMatrix4x4& m, const aiVector3D& min, const aiVector3D& max, aiVector3D& out_min,
+	aiVector3D& out_max)
+{
+	for (unsigned int r = 0; r < 3; ++r) {
+		float lo = m[r][3], hi = m[r][3];
+		for (unsigned int c = 0; c < 3; ++c) {
+			const float e = m[r][c] * min[c], f = m[r][c] * max[c];
+			lo += std::min(e, f);
+			hi += std::max(e, f);
+		}
+		out_min[r] = lo;
+		out_max[r] = hi;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the largest factor by which a matrix scales lengths
+float GetMaxScale(const aiMatrix4x4& m)
+{
+	float scale = 0.f;
+	for (unsigned int c = 0; c < 3; ++c) {
+		scale = std::max(scale, m[0][c] * m[0][c] + m[1][c] * m[1][c] + m[2][c] * m[2][c]);
+	}
+	return std::sqrt(scale);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Extend the box of b to contain the box [min,max]
+void Grow(Bounds& b, const aiVector3D& min, const aiVector3D& max)
+{
+	for (unsigned int c = 0; c < 3; ++c) {
+		b.min[c] = std::min(b.min[c], min[c]);
+		b.max[c] = std::max(b.max[c], max[c]);
+	}
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+void ComputeBox(const aiVector3D* v, unsigned int count, aiVector3D& min, aiVector3D& max)
+{
+	if (!count) {
+		min = max = aiVector3D();
+		return;
+	}
+
+	min = max = v[0];
+	unsigned int i = 1;
+
+#ifdef ASSIMP2GLTF_SSE
+	if (count >= 4) {
+		__m128 min_x, min_y, min_z;
+		LoadTransposed(v, min_x, min_y, min_z);
+		__m128 max_x = min_x, max_y = min_y, max_z = min_z;
+
+		for (i = 4; i + 4 <= count; i += 4) {
+			__m128 x, y, z;
+			LoadTransposed(v + i, x, y, z);
+			min_x = _mm_min_ps(min_x, x);
+			min_y = _mm_min_ps(min_y, y);
+			min_z = _mm_min_ps(min_z, z);
+			max_x = _mm_max_ps(max_x, x);
+			max_y = _mm_max_ps(max_y, y);
+			max_z = _mm_max_ps(max_z, z);
+		}
+
+		min = aiVector3D(HorizontalMin(min_x), HorizontalMin(min_y), HorizontalMin(min_z));
+		max = aiVector3D(HorizontalMax(max_x), HorizontalMax(max_y), HorizontalMax(max_z));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		min.x = std::min(min.x, v[i].x);
+		min.y = std::min(min.y, v[i].y);
+		min.z = std::min(min.z, v[i].z);
+		max.x = std::max(max.x, v[i].x);
+		max.y = std::max(max.y, v[i].y);
+		max.z = std::max(max.z, v[i].z);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void ComputeBounds(const aiMesh& mesh, Bounds& out)
+{
+	ComputeBox(mesh.mVertices, mesh.mNumVertices, out.min, out.max);
+	out.center = (out.min + out.max) * 0.5f;
+	out.radius = std::sqrt(ComputeSquaredRadius(mesh.mVertices, mesh.mNumVertices, out.center));
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneBounds :: Execute(const aiScene* scene, const std::vector<const aiMesh*>& meshes, const SplitMeshList& split,
+	const UniqueContent& content, Assimp::WorkerPool& pool)
+{
+	mesh_bounds.resize(meshes.size());
+	pool.ParallelFor(static_cast<unsigned int>(meshes.size()), [&](unsigned int i) {
+		ComputeBounds(*meshes[i], mesh_bounds[i]);
+	});
+
+	node_bounds.clear();
+	if (scene->mRootNode) {
+		ComputeNode(scene->mRootNode, split, content);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+bool SceneBounds :: ComputeNode(const aiNode* node, const SplitMeshList& split, const UniqueContent& content)
+{
+	// spheres of the parts, in the coordinate system of the node
+	std::vector< std::pair<aiVector3D, float> > spheres;
+
+	Bounds b;
+	b.min = aiVector3D(std::numeric_limits<float>::max());
+	b.max = aiVector3D(-std::numeric_limits<float>::max());
+
+	for (unsigned int n = 0; n < node->mNumMeshes; ++n) {
+		for (unsigned int i = 0; i < split.GetCount(node->mMeshes[n]); ++i) {
+			const unsigned int mesh = split.GetFirst(node->mMeshes[n]) + i;
+			if (!split.GetMeshes()[mesh]->mNumVertices) {
+				continue;
+			}
+
+			const Bounds& part = mesh_bounds[content.GetMesh(mesh)];
+			Grow(b, part.min, part.max);
+			spheres.push_back(std::make_pair(part.center, part.radius));
+		}
+	}
+
+	for (unsigned int n = 0; n < node->mNumChildren; ++n) {
+		const aiNode* const child = node->mChildren[n];
+		if (!ComputeNode(child, split, content)) {
+			continue;
+		}
+
+		const Bounds& part = node_bounds[child];
+		aiVector3D min, max;
+		TransformBox(child->mTransformation, part.min, part.max, min, max);
+		Grow(b, min, max);
+		spheres.push_back(std::make_pair(child->mTransformation * part.center, part.radius * GetMaxScale(child->mTransformation)));
+	}
+
+	if (spheres.empty()) {
+		return false;
+	}
+
+	// both the spheres of the parts and the corners of the box give a sphere
+	// around the center of the box, either may be the smaller one
+	b.center = (b.min + b.max) * 0.5f;
+	b.radius = 0.f;
+	for (size_t i = 0; i < spheres.size(); ++i) {
+		b.radius = std::max(b.radius, (spheres[i].first - b.center).Length() + spheres[i].second);
+	}
+	b.radius = std::min(b.radius, (b.max - b.min).Length() * 0.5f);
+
+	node_bounds[node] = b;
+	return true;
+}
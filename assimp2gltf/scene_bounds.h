@@ -0,0 +1,94 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_SCENE_BOUNDS
+#define INCLUDED_SCENE_BOUNDS
+
+#include <assimp/vector3.h>
+
+#include <map>
+#include <vector>
+
+struct aiScene;
+struct aiMesh;
+struct aiNode;
+class SplitMeshList;
+class UniqueContent;
+
+namespace Assimp {
+	class WorkerPool;
+}
+
+// ---------------------------------------------------------------------------
+/** Axis-aligned box and bounding sphere of a set of points */
+struct Bounds
+{
+	aiVector3D min, max;
+	aiVector3D center;
+	float radius;
+};
+
+// ---------------------------------------------------------------------------
+/** Get the axis-aligned box of an array of points, SSE accelerated where
+ *  available. Both corners are zero for an empty array. */
+void ComputeBox(const aiVector3D* v, unsigned int count, aiVector3D& min, aiVector3D& max);
+
+// ---------------------------------------------------------------------------
+/** Get the box of a mesh's positions and a sphere around them, centered
+ *  on the box. */
+void ComputeBounds(const aiMesh& mesh, Bounds& out);
+
+// ---------------------------------------------------------------------------
+/** Bounds of the output meshes and of the nodes of a scene.
+ *
+ *  Node bounds enclose the meshes of the node and of all its children,
+ *  in the coordinate system of the node itself, i.e. before the node's
+ *  own transformation. Child bounds are carried up through each child's
+ *  transformation, the box as the box of the transformed box and the
+ *  sphere with its radius scaled by the largest scale of the transform.
+ *  Bones and animations are not taken into account.
+ */
+class SceneBounds
+{
+public:
+
+	// -------------------------------------------------------------------
+	/** Compute the bounds of all meshes in parallel, then those of the
+	 *  nodes.
+	 * @param meshes Output meshes, the unique meshes first.
+	 * @param split Split meshes the unique meshes were taken from.
+	 * @param content Maps the split meshes to the unique ones, which
+	 *   are the first entries of meshes.
+	 */
+	void Execute(const aiScene* scene, const std::vector<const aiMesh*>& meshes, const SplitMeshList& split,
+		const UniqueContent& content, Assimp::WorkerPool& pool);
+
+	/** Bounds of an output mesh */
+	const Bounds& GetMesh(unsigned int mesh) const {
+		return mesh_bounds[mesh];
+	}
+
+	/** Bounds of a node, NULL if neither the node nor any of its
+	 *  children have meshes */
+	const Bounds* GetNode(const aiNode* node) const {
+		const std::map<const aiNode*, Bounds>::const_iterator it = node_bounds.find(node);
+		return it == node_bounds.end() ? NULL : &(*it).second;
+	}
+
+private:
+
+	bool ComputeNode(const aiNode* node, const SplitMeshList& split, const UniqueContent& content);
+
+private:
+
+	std::vector<Bounds> mesh_bounds;
+	std::map<const aiNode*, Bounds> node_bounds;
+};
+
+#endif // INCLUDED_SCENE_BOUNDS
@@ -0,0 +1,93 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#include "stream_codec.h"
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <cassert>
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+uint32_t ReadLE(const unsigned char* p, unsigned int size)
+{
+	uint32_t v = 0;
+	for (unsigned int b = 0; b < size; ++b) {
+		v |= static_cast<uint32_t>(p[b]) << (b * 8);
+	}
+	return v;
+}
+
+} // !anon
+
+// ------------------------------------------------------------------------------------------------
+void EncodeIndexDeltas(const unsigned char* data, size_t size, unsigned int index_size,
+	std::vector<unsigned char>& out)
+{
+	assert(index_size == 2 || index_size == 4);
+
+	out.clear();
+	out.reserve(size / index_size * 2);
+
+	uint32_t prev = 0;
+	for (size_t i = 0; i + index_size <= size; i += index_size) {
+		const uint32_t index = ReadLE(data + i, index_size);
+
+		const int32_t delta = static_cast<int32_t>(index - prev);
+		uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+		prev = index;
+
+		while (zigzag >= 0x80) {
+			out.push_back(static_cast<unsigned char>(zigzag | 0x80));
+			zigzag >>= 7;
+		}
+		out.push_back(static_cast<unsigned char>(zigzag));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void EncodeVertexDeltas(const unsigned char* data, size_t size, unsigned int element_size,
+	unsigned int component_size, std::vector<unsigned char>& out)
+{
+	assert(element_size && element_size % component_size == 0);
+
+	const size_t count = size / element_size;
+	out.resize(count * element_size);
+
+	for (unsigned int c = 0; c < element_size; c += component_size) {
+		uint32_t prev = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const uint32_t value = ReadLE(data + i * element_size + c, component_size);
+			const uint32_t delta = value - prev;
+			prev = value;
+
+			for (unsigned int b = 0; b < component_size; ++b) {
+				out[(c + b) * count + i] = static_cast<unsigned char>(delta >> (b * 8));
+			}
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Deflate(const std::vector<unsigned char>& in, std::vector<unsigned char>& out)
+{
+	if (in.empty()) {
+		return false;
+	}
+
+	uLongf length = compressBound(static_cast<uLong>(in.size()));
+	out.resize(length);
+	if (compress2(&out[0], &length, &in[0], static_cast<uLong>(in.size()), Z_DEFAULT_COMPRESSION) != Z_OK || length >= in.size()) {
+		return false;
+	}
+	out.resize(length);
+	return true;
+}
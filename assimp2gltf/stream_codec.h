@@ -0,0 +1,48 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+#ifndef INCLUDED_STREAM_CODEC
+#define INCLUDED_STREAM_CODEC
+
+// ----------------------------------------------------------------------------
+// Encoders for the ASSIMP2GLTF_buffer_compression extension. Each bufferView
+// is filtered to make it more compressible and then optionally deflated.
+// See Readme.md for the decoding steps.
+// ----------------------------------------------------------------------------
+
+#include <vector>
+#include <cstddef>
+
+// ------------------------------------------------------------------------------------------------
+/** Index filter: each index is stored as the difference to the previous
+ *  one (the first to 0), zigzag-mapped to an unsigned integer and written
+ *  as LEB128 varint.
+ *  @param data Little-endian indices of index_size (2 or 4) bytes each.
+ */
+void EncodeIndexDeltas(const unsigned char* data, size_t size, unsigned int index_size,
+	std::vector<unsigned char>& out);
+
+// ------------------------------------------------------------------------------------------------
+/** Vertex filter: each component (of component_size 1, 2 or 4 bytes) is
+ *  replaced by its difference to the same component of the previous
+ *  element, wrapping around as unsigned integer. The result is written as
+ *  byte planes, i.e. first byte 0 of all elements, then byte 1 and so on.
+ *  @param data Tightly packed elements of element_size bytes each.
+ */
+void EncodeVertexDeltas(const unsigned char* data, size_t size, unsigned int element_size,
+	unsigned int component_size, std::vector<unsigned char>& out);
+
+// ------------------------------------------------------------------------------------------------
+/** zlib (RFC 1950) compression.
+ *  @return false if the result wouldn't be smaller than the input, out
+ *    is undefined then.
+ */
+bool Deflate(const std::vector<unsigned char>& in, std::vector<unsigned char>& out);
+
+#endif // INCLUDED_STREAM_CODEC
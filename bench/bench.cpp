@@ -0,0 +1,504 @@
+/*
+assimp2gltf
+Copyright (c) 2011, Alexander C. Gessler
+Copyright (c) 2015, Vinjn Zhang
+
+Licensed under a 3-clause BSD license. See the LICENSE file for more information.
+
+*/
+
+// Throughput benchmark for import, post processing and export. Runs over a fixed
+// set of synthetic scenes and optionally a corpus of files, see Usage().
+
+#include <assimp/Importer.hpp>
+#include <assimp/Exporter.hpp>
+#include <assimp/scene.h>
+
+#include <assimp/../../code/StandardShapes.h>
+#include <assimp/../../code/Subdivision.h>
+#include <assimp/../../code/Profiler.h>
+#include <assimp/../../code/BoostWorkaround/boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/prettywriter.h"
+
+#include "../assimp2gltf/import_settings.h"
+#include "../assimp2gltf/gltf_config.h"
+
+// json_exporter.cpp
+extern Assimp::Exporter::ExportFormatEntry assimp2gltf_desc;
+extern Assimp::Exporter::ExportFormatEntry assimp2glb_desc;
+
+namespace {
+
+using Assimp::Profiling::Profiler;
+
+// Changes smaller than this, in seconds, are timer noise and never count as regression
+const double kNoiseFloor = 1e-4;
+
+// Input for one benchmark scene, either synthetic or from the corpus
+struct BenchInput
+{
+	std::string name;
+
+	// file contents, with the extension as hint
+	std::vector<char> data;
+	std::string hint;
+};
+
+// Timings of one metric over all repetitions
+struct Metric
+{
+	Metric()
+		: bytes()
+		, vertices()
+	{}
+
+	std::vector<double> times;
+
+	// processed per run, for throughput
+	double bytes;
+	double vertices;
+};
+
+typedef std::map<std::string, Metric> MetricMap;
+
+struct Options
+{
+	Options()
+		: warmup(1)
+		, reps(5)
+		, threads(1)
+		, synthetic(true)
+		, threshold(5.0)
+	{}
+
+	unsigned int warmup, reps;
+	int threads;
+	bool synthetic;
+	std::string corpus, filter, json, baseline;
+	double threshold;
+};
+
+// ------------------------------------------------------------------------------------------------
+int Usage()
+{
+	std::cout << "usage: assimp2gltf-bench [--warmup n --reps n --threads n --corpus list.txt --no-synthetic --filter text "
+		"--json results.json --baseline results.json --threshold percent]" << std::endl;
+	return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiScene* MakeScene(aiMesh* mesh)
+{
+	aiScene* const scene = new aiScene();
+	scene->mNumMeshes = 1;
+	scene->mMeshes = new aiMesh*[1];
+	scene->mMeshes[0] = mesh;
+
+	scene->mNumMaterials = 1;
+	scene->mMaterials = new aiMaterial*[1];
+	scene->mMaterials[0] = new aiMaterial();
+
+	scene->mRootNode = new aiNode();
+	scene->mRootNode->mNumMeshes = 1;
+	scene->mRootNode->mMeshes = new unsigned int[1];
+	scene->mRootNode->mMeshes[0] = 0;
+	return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Triangulated sphere, 20 * 4^tess triangles
+aiScene* MakeSphereScene(unsigned int tess)
+{
+	std::vector<aiVector3D> positions;
+	Assimp::StandardShapes::MakeSphere(tess, positions);
+	return MakeScene(Assimp::StandardShapes::MakeMesh(positions, 3));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Catmull-Clark subdivided cube, 6 * 4^levels quads
+aiScene* MakeSubdivisionScene(unsigned int levels)
+{
+	std::vector<aiVector3D> positions;
+	Assimp::StandardShapes::MakeHexahedron(positions, true);
+	aiMesh* const cube = Assimp::StandardShapes::MakeMesh(positions, 4);
+
+	aiMesh* mesh = NULL;
+	boost::scoped_ptr<Assimp::Subdivider> subdivider(Assimp::Subdivider::Create(Assimp::Subdivider::CATMULL_CLARKE));
+	subdivider->Subdivide(cube, mesh, levels, true);
+	return MakeScene(mesh);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Synthetic scenes are stored as OBJ, so they go through a real importer. Returns false on failure.
+bool AddSyntheticInput(std::vector<BenchInput>& inputs, const std::string& name, aiScene* scene)
+{
+	Assimp::Exporter exp;
+	const aiExportDataBlob* const blob = exp.ExportToBlob(scene, "obj");
+	delete scene;
+	if (!blob) {
+		std::cerr << "failure generating " << name << ": " << exp.GetErrorString() << std::endl;
+		return false;
+	}
+
+	BenchInput input;
+	input.name = name;
+	input.hint = "obj";
+	input.data.assign(static_cast<const char*>(blob->data), static_cast<const char*>(blob->data) + blob->size);
+	inputs.push_back(input);
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ReadCorpus(const std::string& list_file, std::vector<BenchInput>& inputs)
+{
+	std::ifstream list(list_file.c_str());
+	if (!list) {
+		std::cerr << "failure reading corpus list: " << list_file << std::endl;
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(list, line)) {
+		if (!line.empty() && line[line.size() - 1] == '\r') {
+			line.resize(line.size() - 1);
+		}
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		std::ifstream file(line.c_str(), std::ios::binary);
+		if (!file) {
+			std::cerr << "failure reading corpus file: " << line << std::endl;
+			return false;
+		}
+
+		BenchInput input;
+		input.name = line;
+		input.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		const std::string::size_type dot = line.find_last_of('.');
+		input.hint = dot == std::string::npos ? std::string() : line.substr(dot + 1);
+		inputs.push_back(input);
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t GetBlobSize(const aiExportDataBlob* blob)
+{
+	size_t size = 0;
+	for (; blob; blob = blob->next) {
+		size += blob->size;
+	}
+	return size;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Import, post process and export input once. Returns false on failure.
+bool RunOnce(const BenchInput& input, int threads, MetricMap* metrics)
+{
+	Assimp::Importer imp;
+	SetupImporter(imp, true, threads);
+
+	const aiScene* const scene = imp.ReadFileFromMemory(&input.data[0], input.data.size(), kPostProcessing, input.hint.c_str());
+	if (!scene) {
+		std::cerr << "failure reading " << input.name << ": " << imp.GetErrorString() << std::endl;
+		return false;
+	}
+
+	Assimp::Exporter exp;
+	exp.RegisterExporter(assimp2gltf_desc);
+	exp.RegisterExporter(assimp2glb_desc);
+
+	Assimp::ExportProperties props;
+	props.SetPropertyInteger(AI_CONFIG_EXPORT_GLTF_THREADS, threads);
+
+	unsigned int vertices, faces;
+	Profiler::CountScene(scene, vertices, faces);
+
+	// the json document with all data inline and the binary container
+	static const char* const formats[][2] = {
+		{ "assimp.gltf", "export:json" },
+		{ "assimp.glb", "export:glb" },
+	};
+	double export_times[2];
+	size_t export_sizes[2];
+	for (unsigned int i = 0; i < 2; ++i) {
+		const double start = Profiler::GetWallTime();
+		const aiExportDataBlob* const blob = exp.ExportToBlob(scene, formats[i][0], 0u, &props);
+		export_times[i] = Profiler::GetWallTime() - start;
+		if (!blob) {
+			std::cerr << "failure exporting " << input.name << ": " << exp.GetErrorString() << std::endl;
+			return false;
+		}
+		export_sizes[i] = GetBlobSize(blob);
+	}
+
+	if (!metrics) {
+		return true;
+	}
+
+	const Assimp::ProfileRegionList& profile = imp.GetProfile();
+	for (size_t i = 0; i < profile.size(); ++i) {
+		const Assimp::ProfileRegion& r = profile[i];
+		Metric& m = (*metrics)[input.name + "/" + r.mName];
+		m.times.push_back(r.mWallTime);
+
+		// the importer and the whole import go from bytes to vertices, steps from vertices to vertices
+		const bool reads_input = r.mName == "total" || !r.mName.compare(0, 7, "import:");
+		m.bytes = reads_input ? static_cast<double>(input.data.size()) : 0.0;
+		m.vertices = reads_input ? r.mVerticesOut : r.mVerticesIn;
+	}
+
+	for (unsigned int i = 0; i < 2; ++i) {
+		Metric& m = (*metrics)[input.name + "/" + formats[i][1]];
+		m.times.push_back(export_times[i]);
+		m.bytes = static_cast<double>(export_sizes[i]);
+		m.vertices = vertices;
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the p-th percentile of sorted times, by nearest rank
+double Percentile(const std::vector<double>& sorted, double p)
+{
+	const size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+	return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ReadBaseline(const std::string& file, std::map<std::string, double>& medians)
+{
+	std::ifstream f(file.c_str());
+	const std::string text((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+	rapidjson::Document doc;
+	doc.Parse(text.c_str());
+	if (!f || doc.HasParseError() || !doc.IsObject() || !doc.HasMember("metrics") || !doc["metrics"].IsArray()) {
+		std::cerr << "failure reading baseline: " << file << std::endl;
+		return false;
+	}
+
+	const rapidjson::Value& list = doc["metrics"];
+	for (rapidjson::SizeType i = 0; i < list.Size(); ++i) {
+		const rapidjson::Value& m = list[i];
+		if (m.IsObject() && m.HasMember("name") && m["name"].IsString() && m.HasMember("median") && m["median"].IsNumber()) {
+			medians[m["name"].GetString()] = m["median"].GetDouble();
+		}
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool WriteResults(const std::string& file, const MetricMap& metrics)
+{
+	rapidjson::StringBuffer sb;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> out(sb);
+
+	out.StartObject();
+	out.Key("metrics");
+	out.StartArray();
+	for (MetricMap::const_iterator it = metrics.begin(); it != metrics.end(); ++it) {
+		std::vector<double> sorted = (*it).second.times;
+		std::sort(sorted.begin(), sorted.end());
+
+		out.StartObject();
+		out.Key("name");
+		out.String((*it).first.c_str());
+		out.Key("median");
+		out.Double(Percentile(sorted, 50.0));
+		out.Key("p90");
+		out.Double(Percentile(sorted, 90.0));
+		out.Key("min");
+		out.Double(sorted.front());
+		out.Key("bytes");
+		out.Double((*it).second.bytes);
+		out.Key("vertices");
+		out.Double((*it).second.vertices);
+		out.EndObject();
+	}
+	out.EndArray();
+	out.EndObject();
+
+	std::ofstream f(file.c_str());
+	f << sb.GetString() << std::endl;
+	if (!f) {
+		std::cerr << "failure writing results: " << file << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Print one line per metric and compare against the baseline. Returns the number of regressions.
+unsigned int Report(const MetricMap& metrics, const std::map<std::string, double>& baseline, double threshold)
+{
+	char line[512];
+	::sprintf(line, "%-64s %10s %10s %10s %9s %9s", "metric", "median ms", "p90 ms", "min ms", "MB/s", "Mvert/s");
+	std::cout << line << (baseline.empty() ? "" : "   vs. baseline") << std::endl;
+
+	unsigned int regressions = 0;
+	for (MetricMap::const_iterator it = metrics.begin(); it != metrics.end(); ++it) {
+		const Metric& m = (*it).second;
+		std::vector<double> sorted = m.times;
+		std::sort(sorted.begin(), sorted.end());
+
+		const double median = Percentile(sorted, 50.0);
+		const double mbs = median > 0.0 && m.bytes > 0.0 ? m.bytes / median * 1e-6 : 0.0;
+		const double mvs = median > 0.0 ? m.vertices / median * 1e-6 : 0.0;
+
+		::sprintf(line, "%-64s %10.3f %10.3f %10.3f %9.1f %9.2f", (*it).first.c_str(),
+			median * 1e3, Percentile(sorted, 90.0) * 1e3, sorted.front() * 1e3, mbs, mvs);
+		std::cout << line;
+
+		std::map<std::string, double>::const_iterator base = baseline.find((*it).first);
+		if (base != baseline.end() && (*base).second > 0.0) {
+			const double change = (median / (*base).second - 1.0) * 100.0;
+			const bool regression = change > threshold && median - (*base).second > kNoiseFloor;
+			regressions += regression;
+
+			::sprintf(line, "   %+7.1f%%%s", change, regression ? "  REGRESSION" : "");
+			std::cout << line;
+		}
+		std::cout << std::endl;
+	}
+	return regressions;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Print the baseline metrics of the inputs that ran which were not measured this time, e.g.
+// because the input failed or a step no longer runs. Returns their number.
+unsigned int ReportMissing(const MetricMap& metrics, const std::map<std::string, double>& baseline,
+	const std::set<std::string>& ran)
+{
+	unsigned int missing = 0;
+	for (std::map<std::string, double>::const_iterator it = baseline.begin(); it != baseline.end(); ++it) {
+		const std::string& name = (*it).first;
+		if (metrics.find(name) != metrics.end()) {
+			continue;
+		}
+
+		// metrics are named input/region, and corpus inputs are paths themselves
+		for (std::string::size_type sep = name.find('/'); sep != std::string::npos; sep = name.find('/', sep + 1)) {
+			if (ran.find(name.substr(0, sep)) != ran.end()) {
+				char line[512];
+				::sprintf(line, "%-64s %10s", name.c_str(), "MISSING");
+				std::cout << line << std::endl;
+				++missing;
+				break;
+			}
+		}
+	}
+	return missing;
+}
+
+} // !anon
+
+int main (int argc, char *argv[])
+{
+	Options opts;
+	for (int i = 1; i < argc; ++i) {
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i],"--warmup") && has_value) {
+			opts.warmup = static_cast<unsigned int>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i],"--reps") && has_value) {
+			opts.reps = std::max(1, atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i],"--threads") && has_value) {
+			opts.threads = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i],"--corpus") && has_value) {
+			opts.corpus = argv[++i];
+		}
+		else if (!strcmp(argv[i],"--no-synthetic")) {
+			opts.synthetic = false;
+		}
+		else if (!strcmp(argv[i],"--filter") && has_value) {
+			opts.filter = argv[++i];
+		}
+		else if (!strcmp(argv[i],"--json") && has_value) {
+			opts.json = argv[++i];
+		}
+		else if (!strcmp(argv[i],"--baseline") && has_value) {
+			opts.baseline = argv[++i];
+		}
+		else if (!strcmp(argv[i],"--threshold") && has_value) {
+			opts.threshold = atof(argv[++i]);
+		}
+		else {
+			return Usage();
+		}
+	}
+
+	std::map<std::string, double> baseline;
+	if (!opts.baseline.empty() && !ReadBaseline(opts.baseline, baseline)) {
+		return -2;
+	}
+
+	// fixed sizes, so results are comparable between runs
+	std::vector<BenchInput> inputs;
+	unsigned int failures = 0;
+	if (opts.synthetic) {
+		failures += !AddSyntheticInput(inputs, "sphere-5k", MakeSphereScene(4));
+		failures += !AddSyntheticInput(inputs, "sphere-80k", MakeSphereScene(6));
+		failures += !AddSyntheticInput(inputs, "subdiv-25k", MakeSubdivisionScene(6));
+		failures += !AddSyntheticInput(inputs, "subdiv-390k", MakeSubdivisionScene(8));
+	}
+	if (!opts.corpus.empty() && !ReadCorpus(opts.corpus, inputs)) {
+		return -2;
+	}
+
+	MetricMap metrics;
+	std::set<std::string> ran;
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		const BenchInput& input = inputs[i];
+		if (input.data.empty() || (!opts.filter.empty() && input.name.find(opts.filter) == std::string::npos)) {
+			continue;
+		}
+
+		std::cerr << input.name << " (" << input.data.size() / 1024 << " KiB)" << std::endl;
+		ran.insert(input.name);
+		bool ok = true;
+		for (unsigned int n = 0; ok && n < opts.warmup; ++n) {
+			ok = RunOnce(input, opts.threads, NULL);
+		}
+		for (unsigned int n = 0; ok && n < opts.reps; ++n) {
+			ok = RunOnce(input, opts.threads, &metrics);
+		}
+		failures += !ok;
+	}
+
+	const unsigned int regressions = Report(metrics, baseline, opts.threshold);
+	const unsigned int missing = ReportMissing(metrics, baseline, ran);
+	if (!opts.json.empty() && !WriteResults(opts.json, metrics)) {
+		return -3;
+	}
+
+	if (failures) {
+		std::cerr << failures << " inputs failed" << std::endl;
+	}
+	if (missing) {
+		std::cerr << missing << " baseline metrics are missing" << std::endl;
+	}
+	if (regressions) {
+		std::cerr << regressions << " metrics regressed by more than " << opts.threshold << "%" << std::endl;
+	}
+	return failures || missing || regressions ? 1 : 0;
+}